@@ -0,0 +1,219 @@
+/**
+ * @file ArrayIndexTest.cpp
+ * @brief randomized tests of the lookups of indexed arrays, see stdXmlArrayIndex
+ * @author Nicolas Macherey (nm@graymat.fr)
+ * @version 10.4
+ */
+#define BOOST_TEST_MODULE ArrayIndexTest
+#include <boost/test/unit_test.hpp>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <libxml/xmlreader.h>
+
+#include "HolidayType.h"
+#include "PersonHolidaysType.h"
+
+/** number of random operations of each test */
+#define TEST_STEPS 2000
+
+/** number of distinct keys, small enough for many items to share their key */
+#define TEST_KEYS 12
+
+/** Linear congruential generator, the tests do not depend on the platform rand */
+class TestRandom
+{
+public :
+	TestRandom( unsigned int seed ): m_state( seed ) {};
+
+	/** Get a number in [0, count) */
+	unsigned int Next( unsigned int count )
+	{
+		m_state = m_state * 1103515245u + 12345u;
+		return ( m_state >> 16 ) % count;
+	};
+
+	/** Get one of the test keys */
+	std::string NextKey()
+	{
+		char key[8];
+		sprintf( key , "k%u" , Next( TEST_KEYS ) );
+		return key;
+	};
+
+private :
+	unsigned int m_state;
+};
+
+/** Create an item with the given key */
+static HolidayType MakeHoliday( const std::string& start , unsigned int end )
+{
+	HolidayType holiday;
+	holiday.SetStart( start );
+	holiday.SetEnd( std::string( "e" ) + (char)( 'a' + end % 4 ) );
+
+	return holiday;
+}
+
+/** Find the first item having the given key by a linear scan */
+static int ScanByStart( const PersonHolidaysType& object , const std::string& key )
+{
+	const std::vector< HolidayType >& items = object.GetHoliday();
+
+	for( unsigned int i = 0 ; i < items.size() ; ++i )
+		if( items[i].GetStart() == key )
+			return i;
+
+	return stdNOT_FOUND;
+}
+
+/** Find the first item equal to the given one by a linear scan */
+static int ScanByValue( const PersonHolidaysType& object , const HolidayType& value )
+{
+	const std::vector< HolidayType >& items = object.GetHoliday();
+
+	for( unsigned int i = 0 ; i < items.size() ; ++i )
+		if( items[i] == value )
+			return i;
+
+	return stdNOT_FOUND;
+}
+
+/** Check every lookup of the object against a linear scan */
+static void CheckLookups( PersonHolidaysType& object , unsigned int step )
+{
+	const PersonHolidaysType& constObject = object;
+
+	for( unsigned int k = 0 ; k < TEST_KEYS ; ++k ) {
+		char key[8];
+		sprintf( key , "k%u" , k );
+		int expected = ScanByStart( object , key );
+
+		const HolidayType* found = constObject.FindHolidayByStart( key );
+		BOOST_CHECK_MESSAGE( found == ( expected == stdNOT_FOUND ? NULL : &constObject.GetHoliday()[expected] ) ,
+			"const lookup of " << key << " at step " << step );
+		BOOST_CHECK_MESSAGE( constObject.HolidayExistsByStart( key ) == ( expected != stdNOT_FOUND ) ,
+			"existence of " << key << " at step " << step );
+
+		HolidayType* lent = object.FindHolidayByStart( key );
+		BOOST_CHECK_MESSAGE( lent == ( expected == stdNOT_FOUND ? NULL : &object.GetHoliday()[expected] ) ,
+			"lookup of " << key << " at step " << step );
+	}
+
+	if( !object.GetHoliday().empty() ) {
+		HolidayType value = object.GetHoliday()[ step % object.GetHoliday().size() ];
+		BOOST_CHECK_MESSAGE( object.FindIndexByHoliday( value ) == ScanByValue( object , value ) ,
+			"lookup by value at step " << step );
+	}
+}
+
+/** Apply random modifications to an indexed array, checking its lookups after
+  * each of them */
+static void RunRandomEdits( unsigned int seed )
+{
+	TestRandom random( seed );
+	PersonHolidaysType object;
+
+	for( unsigned int step = 0 ; step < TEST_STEPS ; ++step ) {
+		unsigned int count = object.GetHoliday().size();
+		unsigned int operation = random.Next( 9 );
+
+		/* keep the array between a few and a few dozen items */
+		if( count < 4 )
+			operation = 0;
+		else if( count > 48 && operation >= 6 )
+			operation = 1;
+
+		switch( operation ) {
+		case 0 :
+			object.AddHoliday( MakeHoliday( random.NextKey() , random.Next( 4 ) ) );
+			break;
+		case 1 :
+			object.RemoveHolidayByIndex( random.Next( count ) );
+			break;
+		case 2 :
+			object.SetHolidayAt( MakeHoliday( random.NextKey() , random.Next( 4 ) ) , random.Next( count ) );
+			break;
+		case 3 :
+			/* the item is lent, its new key is read by the next lookup */
+			object.GetHolidayAt( random.Next( count ) ).SetStart( random.NextKey() );
+			break;
+		case 4 : {
+			HolidayType* item = object.FindHolidayByStart( random.NextKey() );
+
+			if( item != NULL )
+				item->SetStart( random.NextKey() );
+
+			break;
+		}
+		case 5 : {
+			/* a reference kept across lookups needs the index to be rebuilt */
+			HolidayType& item = object.GetHolidayAt( random.Next( count ) );
+			object.FindHolidayByStart( random.NextKey() );
+			item.SetStart( random.NextKey() );
+			object.ReindexHoliday();
+			break;
+		}
+		case 6 :
+			object.EmplaceHoliday().SetStart( random.NextKey() );
+			break;
+		case 7 : {
+			PersonHolidaysType copy( object );
+			copy.AddHoliday( MakeHoliday( random.NextKey() , random.Next( 4 ) ) );
+			object = copy;
+			break;
+		}
+		default :
+			object.AddHoliday( MakeHoliday( random.NextKey() , random.Next( 4 ) ) );
+			break;
+		}
+
+		CheckLookups( object , step );
+	}
+}
+
+/** Lookups match a linear scan after random modifications */
+BOOST_AUTO_TEST_CASE( RandomEdits )
+{
+	RunRandomEdits( 1 );
+	RunRandomEdits( 42 );
+	RunRandomEdits( 20100508 );
+}
+
+/** Several items modified in place between two lookups are found by their new key */
+BOOST_AUTO_TEST_CASE( ManyLentItems )
+{
+	PersonHolidaysType object;
+
+	for( unsigned int i = 0 ; i < 64 ; ++i )
+		object.AddHoliday( MakeHoliday( "old" , i ) );
+
+	BOOST_CHECK( object.FindHolidayByStart( "old" ) == &object.GetHoliday()[0] );
+
+	for( unsigned int i = 0 ; i < 64 ; i += 2 )
+		object.GetHolidayAt( i ).SetStart( "new" );
+
+	CheckLookups( object , 0 );
+	BOOST_CHECK( object.FindHolidayByStart( "old" ) == &object.GetHoliday()[1] );
+	BOOST_CHECK( object.FindHolidayByStart( "new" ) == &object.GetHoliday()[0] );
+}
+
+/** Looking up a const object neither thaws it nor copies its shared array */
+BOOST_AUTO_TEST_CASE( ConstLookup )
+{
+	PersonHolidaysType object;
+	object.AddHoliday( MakeHoliday( "k0" , 0 ) );
+	object.Freeze();
+
+	const PersonHolidaysType copy( object );
+	BOOST_CHECK( copy.FindHolidayByStart( "k0" ) != NULL );
+	BOOST_CHECK( copy.HolidayExistsByStart( "k0" ) );
+	BOOST_CHECK( !copy.HolidayExistsByStart( "k1" ) );
+
+	const PersonHolidaysType& constObject = object;
+	BOOST_CHECK( constObject.HolidayExistsByStart( "k0" ) );
+	BOOST_CHECK( object.IsFrozen() );
+	BOOST_CHECK( &copy.GetHoliday()[0] == &constObject.GetHoliday()[0] );
+}
@@ -0,0 +1,125 @@
+/**
+ * @file BinaryDeltaTest.cpp
+ * @brief tests of the deltas written between generated objects, see stdBinaryDelta.h
+ * @author Nicolas Macherey (nm@graymat.fr)
+ * @version 10.4
+ */
+#define BOOST_TEST_MODULE BinaryDeltaTest
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+
+#include <libxml/xmlreader.h>
+
+#include <stdException.h>
+#include <stdXmlParseContext.h>
+#include <stdBinarySerializer.h>
+
+#include "HolidaysType.h"
+#include "PersonHolidaysType.h"
+#include "PersonType.h"
+
+/** Load the demo document */
+static HolidaysType* LoadDemo( stdXmlParseContext& context )
+{
+	HolidaysType* root = dynamic_cast< HolidaysType* >( context.LoadFile( DEMO_FILE ) );
+	BOOST_REQUIRE( root != NULL );
+	BOOST_REQUIRE( root->GetPersonHolidays().size() >= 2 );
+	BOOST_REQUIRE( !root->GetPersonHolidays()[0].GetHoliday().empty() );
+
+	return root;
+}
+
+/** Check that patching a copy of from with the delta to to gives to
+  * @return the size of the delta */
+static size_t CheckRoundTrip( const HolidaysType& from , const HolidaysType& to )
+{
+	std::string delta = stdBinarySerializer::Get()->Diff( from , to );
+	HolidaysType patched( from );
+	stdBinarySerializer::Get()->Patch( patched , delta );
+
+	BOOST_CHECK( patched == to );
+	stdXmlParseContext context;
+	BOOST_CHECK_EQUAL( context.StringSerialize( &patched ) , context.StringSerialize( const_cast< HolidaysType* >( &to ) ) );
+
+	return delta.size();
+}
+
+/** Equal objects have an empty delta */
+BOOST_AUTO_TEST_CASE( EqualObjects )
+{
+	stdXmlParseContext context;
+	HolidaysType* root = LoadDemo( context );
+	HolidaysType copy( *root );
+
+	BOOST_CHECK( stdBinarySerializer::Get()->Diff( *root , copy ).empty() );
+	BOOST_CHECK_EQUAL( CheckRoundTrip( *root , copy ) , 0u );
+
+	delete root;
+}
+
+/** Patching with the delta of a modification gives the modified object, and the
+  * delta is smaller than the encoding of the object */
+BOOST_AUTO_TEST_CASE( Modifications )
+{
+	stdXmlParseContext context;
+	HolidaysType* root = LoadDemo( context );
+	size_t full = stdBinarySerializer::Get()->Serialize( root ).size();
+
+	for( unsigned int test = 0 ; test < 6 ; ++test ) {
+		HolidaysType modified( *root );
+		std::vector< PersonHolidaysType >& items = modified.GetPersonHolidays();
+
+		switch( test ) {
+		case 0 :
+			items[1].GetPerson().SetCity( "Paris" );
+			break;
+		case 1 :
+			items[0].GetHoliday().erase( items[0].GetHoliday().begin() );
+			break;
+		case 2 : {
+			PersonType person;
+			person.SetFirstname( "New" );
+			PersonHolidaysType item;
+			item.SetPerson( person );
+			items.insert( items.begin() + 1 , item );
+			break;
+		}
+		case 3 :
+			/* the value of an unset member is not encoded, it is reset by the patch */
+			items[0].GetPerson().SetAge( 0 );
+			items[0].GetPerson().SetHasAge( false );
+			break;
+		case 4 :
+			items[0].GetPerson().SetAge( 7 );
+			break;
+		default :
+			items.pop_back();
+			items[0].GetHoliday()[0].SetStart( "2010-05-08" );
+			break;
+		}
+
+		size_t size = CheckRoundTrip( *root , modified );
+		BOOST_CHECK_MESSAGE( size > 0 && size < full , "size of delta " << test );
+
+		/* the reverse delta restores the original object */
+		CheckRoundTrip( modified , *root );
+	}
+
+	delete root;
+}
+
+/** A delta applied to an object it does not match is refused */
+BOOST_AUTO_TEST_CASE( MismatchedPatch )
+{
+	stdXmlParseContext context;
+	HolidaysType* root = LoadDemo( context );
+	HolidaysType modified( *root );
+	modified.GetPersonHolidays().back().GetHoliday().push_back( HolidayType() );
+
+	std::string delta = stdBinarySerializer::Get()->Diff( *root , modified );
+	HolidaysType empty;
+	BOOST_CHECK_THROW( stdBinarySerializer::Get()->Patch( empty , delta ) , stdException );
+
+	delete root;
+}
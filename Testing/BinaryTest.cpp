@@ -0,0 +1,80 @@
+/**
+ * @file BinaryTest.cpp
+ * @brief tests of the compact binary format written by the generated binary handlers
+ * @author Nicolas Macherey (nm@graymat.fr)
+ * @version 10.4
+ */
+#define BOOST_TEST_MODULE BinaryTest
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+
+#include <libxml/xmlreader.h>
+
+#include <stdException.h>
+#include <stdXmlParseContext.h>
+#include <stdBinarySerializer.h>
+
+#include "HolidaysType.h"
+#include "PersonHolidaysType.h"
+#include "PersonType.h"
+
+/** Load the demo document */
+static HolidaysType* LoadDemo( stdXmlParseContext& context )
+{
+	HolidaysType* root = dynamic_cast< HolidaysType* >( context.LoadFile( DEMO_FILE ) );
+	BOOST_REQUIRE( root != NULL );
+	BOOST_REQUIRE( !root->GetPersonHolidays().empty() );
+
+	return root;
+}
+
+/** A document read back from its binary encoding is equal to the original one */
+BOOST_AUTO_TEST_CASE( RoundTrip )
+{
+	stdXmlParseContext context;
+	HolidaysType* root = LoadDemo( context );
+
+	std::string data = stdBinarySerializer::Get()->Serialize( root );
+	BOOST_CHECK( data.size() < context.StringSerialize( root ).size() );
+
+	HolidaysType* copy = dynamic_cast< HolidaysType* >( stdBinarySerializer::Get()->Load( data ) );
+	BOOST_REQUIRE( copy != NULL );
+	BOOST_CHECK( *copy == *root );
+	BOOST_CHECK_EQUAL( context.StringSerialize( copy ) , context.StringSerialize( root ) );
+	BOOST_CHECK( stdBinarySerializer::Get()->Serialize( copy ) == data );
+
+	delete copy;
+	delete root;
+}
+
+/** Unset members are not written and stay unset */
+BOOST_AUTO_TEST_CASE( UnsetMembers )
+{
+	PersonType person;
+	person.SetFirstname( "Toto" );
+	person.SetAge( 42 );
+
+	PersonType* copy = dynamic_cast< PersonType* >( stdBinarySerializer::Get()->Load(
+		stdBinarySerializer::Get()->Serialize( &person ) ) );
+	BOOST_REQUIRE( copy != NULL );
+	BOOST_CHECK( *copy == person );
+	BOOST_CHECK_EQUAL( copy->GetAge() , 42u );
+	BOOST_CHECK( copy->HasFirstname() );
+	BOOST_CHECK( !copy->HasCity() );
+
+	delete copy;
+}
+
+/** Truncated encodings are refused */
+BOOST_AUTO_TEST_CASE( Truncated )
+{
+	stdXmlParseContext context;
+	HolidaysType* root = LoadDemo( context );
+	std::string data = stdBinarySerializer::Get()->Serialize( root );
+
+	for( size_t size = 0 ; size < data.size() ; size += data.size() / 64 + 1 )
+		BOOST_CHECK_THROW( delete stdBinarySerializer::Get()->Load( data.substr( 0 , size ) ) , stdException );
+
+	delete root;
+}
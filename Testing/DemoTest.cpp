@@ -0,0 +1,56 @@
+/**
+ * @file DemoTest.cpp
+ * @brief tests of the code generated for the demo schema
+ * @author Nicolas Macherey (nm@graymat.fr)
+ * @version 10.4
+ */
+#define BOOST_TEST_MODULE DemoTest
+#include <boost/test/unit_test.hpp>
+
+#include <map>
+#include <string>
+
+#include <libxml/xmlreader.h>
+
+#include <stdXmlReader.h>
+
+#include "HolidaysType.h"
+#include "PersonHolidaysType.h"
+#include "PersonType.h"
+
+/** The demo document is read and written back with its content */
+BOOST_AUTO_TEST_CASE( LoadAndSave )
+{
+	HolidaysType* root = dynamic_cast< HolidaysType* >( stdXmlReader::Get()->LoadFile( DEMO_FILE ) );
+	BOOST_REQUIRE( root != NULL );
+	BOOST_REQUIRE( !root->GetPersonHolidays().empty() );
+	BOOST_CHECK_EQUAL( root->GetPersonHolidays()[0].GetPerson().GetCity() , "Toto City" );
+
+	std::string data = stdXmlReader::Get()->StringSerialize( root );
+	BOOST_CHECK( data.find( "Toto City" ) != std::string::npos );
+
+	stdXmlReader::Get()->SaveFile( "DemoTest.xml" , root );
+	HolidaysType* copy = dynamic_cast< HolidaysType* >( stdXmlReader::Get()->LoadFile( "DemoTest.xml" ) );
+	BOOST_REQUIRE( copy != NULL );
+	BOOST_CHECK( *copy == *root );
+	BOOST_CHECK_EQUAL( stdXmlReader::Get()->StringSerialize( copy ) , data );
+
+	delete copy;
+	delete root;
+}
+
+/** Copies of the objects are equal to them until they are modified */
+BOOST_AUTO_TEST_CASE( CopyAndCompare )
+{
+	HolidaysType* root = dynamic_cast< HolidaysType* >( stdXmlReader::Get()->LoadFile( DEMO_FILE ) );
+	BOOST_REQUIRE( root != NULL );
+
+	HolidaysType copy( *root );
+	BOOST_CHECK( copy == *root );
+
+	copy.GetPersonHolidays()[0].GetPerson().SetCity( "Lyon" );
+	BOOST_CHECK( !( copy == *root ) );
+	BOOST_CHECK_EQUAL( root->GetPersonHolidays()[0].GetPerson().GetCity() , "Toto City" );
+
+	delete root;
+}
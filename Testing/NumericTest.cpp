@@ -0,0 +1,141 @@
+/**
+ * @file NumericTest.cpp
+ * @brief tests of the numeric parsing and formatting used by the generated handlers
+ * @author Nicolas Macherey (nm@graymat.fr)
+ * @version 10.4
+ */
+#define BOOST_TEST_MODULE NumericTest
+#include <boost/test/unit_test.hpp>
+
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <string>
+
+#include <stdNumeric.h>
+
+/** Format the given value */
+template< class T > static std::string Format( T value )
+{
+	char buffer[stdNUMERIC_BUFFER_SIZE];
+	int count = stdFormatNumber( buffer , value );
+	BOOST_CHECK_EQUAL( count , (int) strlen( buffer ) );
+
+	return buffer;
+}
+
+/** Parse the given string, the value is left unchanged if it cannot be read */
+template< class T > static T Parse( const char* str , T value )
+{
+	stdParseNumber( str , value );
+	return value;
+}
+
+/** Generator of bit patterns, the tests do not depend on the platform rand */
+static unsigned long long NextBits( unsigned long long& state )
+{
+	state = state * 6364136223846793005ull + 1442695040888963407ull;
+	return state;
+}
+
+/** Out of range integers are clamped */
+BOOST_AUTO_TEST_CASE( IntegerOverflow )
+{
+	BOOST_CHECK_EQUAL( Parse( "2147483647" , 0 ) , INT_MAX );
+	BOOST_CHECK_EQUAL( Parse( "2147483648" , 0 ) , INT_MAX );
+	BOOST_CHECK_EQUAL( Parse( "99999999999999999999999" , 0 ) , INT_MAX );
+	BOOST_CHECK_EQUAL( Parse( "-2147483648" , 0 ) , INT_MIN );
+	BOOST_CHECK_EQUAL( Parse( "-2147483649" , 0 ) , INT_MIN );
+	BOOST_CHECK_EQUAL( Parse( "4294967296" , 0u ) , UINT_MAX );
+	BOOST_CHECK_EQUAL( Parse( "99999999999999999999999" , 0l ) , LONG_MAX );
+	BOOST_CHECK_EQUAL( Parse( "-99999999999999999999999" , 0l ) , LONG_MIN );
+	BOOST_CHECK_EQUAL( Parse( "99999999999999999999999" , 0ul ) , ULONG_MAX );
+
+	BOOST_CHECK_EQUAL( Format( INT_MIN ) , "-2147483648" );
+	BOOST_CHECK_EQUAL( Parse( Format( LONG_MIN ).c_str() , 0l ) , LONG_MIN );
+	BOOST_CHECK_EQUAL( Parse( Format( ULONG_MAX ).c_str() , 0ul ) , ULONG_MAX );
+}
+
+/** Numbers are read like a stream extraction would do */
+BOOST_AUTO_TEST_CASE( IntegerSyntax )
+{
+	BOOST_CHECK_EQUAL( Parse( " \t\n+42" , 0 ) , 42 );
+	BOOST_CHECK_EQUAL( Parse( "-17" , 0 ) , -17 );
+	BOOST_CHECK_EQUAL( Parse( "12abc" , 0 ) , 12 );
+	BOOST_CHECK_EQUAL( Parse( "" , 7 ) , 7 );
+	BOOST_CHECK_EQUAL( Parse( "abc" , 7 ) , 7 );
+	BOOST_CHECK_EQUAL( Parse( "-" , 7 ) , 7 );
+
+	int value = 7;
+	BOOST_CHECK( !stdParseNumber( "x" , value ) );
+	BOOST_CHECK( stdParseNumber( "0" , value ) );
+	BOOST_CHECK_EQUAL( value , 0 );
+}
+
+/** Infinities and not a number are read in their schema form and read back */
+BOOST_AUTO_TEST_CASE( InfinityAndNaN )
+{
+	BOOST_CHECK( Parse( "INF" , 0.0 ) == HUGE_VAL );
+	BOOST_CHECK( Parse( "-INF" , 0.0 ) == -HUGE_VAL );
+	BOOST_CHECK( Parse( "INF" , 0.0f ) == HUGE_VALF );
+
+	double nan = Parse( "NaN" , 0.0 );
+	BOOST_CHECK( nan != nan );
+	float nanf = Parse( "NaN" , 0.0f );
+	BOOST_CHECK( nanf != nanf );
+
+	BOOST_CHECK( Parse( Format( HUGE_VAL ).c_str() , 0.0 ) == HUGE_VAL );
+	BOOST_CHECK( Parse( Format( -HUGE_VAL ).c_str() , 0.0 ) == -HUGE_VAL );
+	BOOST_CHECK( Parse( Format( HUGE_VALF ).c_str() , 0.0f ) == HUGE_VALF );
+
+	nan = Parse( Format( nan ).c_str() , 0.0 );
+	BOOST_CHECK( nan != nan );
+
+	/* out of range values are clamped to infinity or zero */
+	BOOST_CHECK( Parse( "1e999" , 0.0 ) == HUGE_VAL );
+	BOOST_CHECK( Parse( "1e-999" , 1.0 ) == 0.0 );
+	BOOST_CHECK( Parse( "1e99" , 0.0f ) == HUGE_VALF );
+}
+
+/** Floating point values are written with their shortest representation */
+BOOST_AUTO_TEST_CASE( ShortestRepresentation )
+{
+	BOOST_CHECK_EQUAL( Format( 0.1 ) , "0.1" );
+	BOOST_CHECK_EQUAL( Format( 0.1f ) , "0.1" );
+	BOOST_CHECK_EQUAL( Format( 1.5 ) , "1.5" );
+	BOOST_CHECK_EQUAL( Format( -2.0 ) , "-2" );
+	BOOST_CHECK_EQUAL( Format( 0.0 ) , "0" );
+	BOOST_CHECK_EQUAL( Parse( Format( 1.0 / 3.0 ).c_str() , 0.0 ) , 1.0 / 3.0 );
+	BOOST_CHECK_EQUAL( Parse( Format( 5e-324 ).c_str() , 0.0 ) , 5e-324 );
+	BOOST_CHECK_EQUAL( Parse( Format( 1.7976931348623157e308 ).c_str() , 0.0 ) , 1.7976931348623157e308 );
+	BOOST_CHECK_EQUAL( Parse( Format( 16777217.0f ).c_str() , 0.0f ) , 16777217.0f );
+}
+
+/** Every finite value reads back to itself */
+BOOST_AUTO_TEST_CASE( RoundTrip )
+{
+	unsigned long long state = 20100508;
+
+	for( unsigned int i = 0 ; i < 20000 ; ++i ) {
+		unsigned long long bits = NextBits( state );
+
+		double value;
+		memcpy( &value , &bits , sizeof( value ) );
+
+		if( value == value && value != HUGE_VAL && value != -HUGE_VAL ) {
+			std::string str = Format( value );
+			BOOST_CHECK_MESSAGE( Parse( str.c_str() , 0.0 ) == value , str );
+			BOOST_CHECK( str.size() <= 24 );
+		}
+
+		unsigned int half = (unsigned int) ( bits >> 32 );
+		float single;
+		memcpy( &single , &half , sizeof( single ) );
+
+		if( single == single && single != HUGE_VALF && single != -HUGE_VALF ) {
+			std::string str = Format( single );
+			BOOST_CHECK_MESSAGE( Parse( str.c_str() , 0.0f ) == single , str );
+			BOOST_CHECK( str.size() <= 15 );
+		}
+	}
+}
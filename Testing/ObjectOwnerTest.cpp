@@ -0,0 +1,141 @@
+/**
+ * @file ObjectOwnerTest.cpp
+ * @brief tests of the hash and the bytes kept by frozen generated objects
+ * @author Nicolas Macherey (nm@graymat.fr)
+ * @version 10.4
+ */
+#define BOOST_TEST_MODULE ObjectOwnerTest
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+
+#include <libxml/xmlreader.h>
+
+#include <stdXmlParseContext.h>
+
+#include "HolidaysType.h"
+#include "PersonHolidaysType.h"
+#include "PersonType.h"
+
+/** Load the demo document */
+static HolidaysType* LoadDemo( stdXmlParseContext& context )
+{
+	HolidaysType* root = dynamic_cast< HolidaysType* >( context.LoadFile( DEMO_FILE ) );
+	BOOST_REQUIRE( root != NULL );
+	BOOST_REQUIRE( !root->GetPersonHolidays().empty() );
+
+	return root;
+}
+
+/** Saving a frozen document again sees the members modified through a reference
+  * kept since it has been frozen */
+BOOST_AUTO_TEST_CASE( FragmentOfKeptReference )
+{
+	stdXmlParseContext context;
+	context.SetFragmentCaching( true );
+	HolidaysType* root = LoadDemo( context );
+
+	PersonType& person = root->GetPersonHolidays()[0].GetPerson();
+	root->Freeze();
+	std::string first = context.StringSerialize( root );
+	BOOST_CHECK( first.find( "Toto City" ) != std::string::npos );
+	BOOST_CHECK( root->GetXmlFragment() != NULL && root->GetXmlFragment()->IsValid() );
+
+	person.SetCity( "Lyon" );
+	BOOST_CHECK( !root->IsFrozen() );
+	std::string second = context.StringSerialize( root );
+	BOOST_CHECK( second.find( "Toto City" ) == std::string::npos );
+	BOOST_CHECK( second.find( "Lyon" ) != std::string::npos );
+
+	/* an unmodified frozen document is written from its fragments */
+	root->Freeze();
+	BOOST_CHECK_EQUAL( context.StringSerialize( root ) , second );
+	BOOST_CHECK_EQUAL( context.StringSerialize( root ) , second );
+
+	delete root;
+}
+
+/** Saving a frozen document again sees the arrays modified through a reference
+  * taken since it has been frozen */
+BOOST_AUTO_TEST_CASE( FragmentOfArrayReference )
+{
+	stdXmlParseContext context;
+	context.SetFragmentCaching( true );
+	HolidaysType* root = LoadDemo( context );
+	BOOST_REQUIRE( !root->GetPersonHolidaysAt( 0 ).GetHoliday().empty() );
+
+	root->Freeze();
+	std::vector< HolidayType >& holidays = root->GetPersonHolidaysAt( 0 ).GetHoliday();
+	std::string first = context.StringSerialize( root );
+
+	holidays.clear();
+	std::string second = context.StringSerialize( root );
+	BOOST_CHECK( second != first );
+
+	stdXmlParseContext plain;
+	BOOST_CHECK_EQUAL( second , plain.StringSerialize( root ) );
+
+	delete root;
+}
+
+/** The hash of a frozen object changes when one of its members is modified
+  * through a reference kept since it has been frozen */
+BOOST_AUTO_TEST_CASE( HashOfKeptReference )
+{
+	stdXmlParseContext context;
+	HolidaysType* a = LoadDemo( context );
+	HolidaysType b( *a );
+
+	PersonType& pa = a->GetPersonHolidays()[0].GetPerson();
+	PersonType& pb = b.GetPersonHolidays()[0].GetPerson();
+	a->Freeze();
+	b.Freeze();
+	std::size_t hash = a->GetHash();
+	BOOST_CHECK_EQUAL( hash , b.GetHash() );
+
+	pa.SetCity( "X" );
+	BOOST_CHECK( !a->IsFrozen() );
+	BOOST_CHECK( a->GetHash() != hash );
+	BOOST_CHECK( !( *a == b ) );
+
+	pb.SetCity( "X" );
+	BOOST_CHECK_EQUAL( a->GetHash() , b.GetHash() );
+	BOOST_CHECK( *a == b );
+
+	delete a;
+}
+
+/** Hashing an object which is not frozen does not keep its hash, so that a
+  * member modified through a reference is never compared by a stale hash */
+BOOST_AUTO_TEST_CASE( HashOfArrayReference )
+{
+	PersonHolidaysType p;
+	PersonHolidaysType q;
+
+	std::vector< HolidayType >& v = p.GetHoliday();
+	v.push_back( HolidayType() );
+	p.GetHash();
+	q.GetHash();
+	BOOST_CHECK( !p.IsFrozen() );
+
+	v.clear();
+	BOOST_CHECK( p == q );
+	BOOST_CHECK_EQUAL( p.GetHash() , q.GetHash() );
+}
+
+/** A member does not notify its owner once the owner has been destroyed */
+BOOST_AUTO_TEST_CASE( DestroyedOwner )
+{
+	stdXmlParseContext context;
+	HolidaysType* owner = LoadDemo( context );
+	std::vector< PersonHolidaysType > items;
+
+	/* the items are linked to the owner when it is frozen, then taken out of it */
+	owner->Freeze();
+	items.swap( owner->GetPersonHolidays() );
+	delete owner;
+
+	items[0].GetPerson().SetCity( "Y" );
+	BOOST_CHECK_EQUAL( items[0].GetPerson().GetCity() , "Y" );
+}
@@ -0,0 +1,96 @@
+/**
+ * @file XmlWriterTest.cpp
+ * @brief tests of the documents written by the generated handlers without a DOM tree
+ * @author Nicolas Macherey (nm@graymat.fr)
+ * @version 10.4
+ */
+#define BOOST_TEST_MODULE XmlWriterTest
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+
+#include <libxml/xmlreader.h>
+#include <libxml/tree.h>
+
+#include <stdXmlReader.h>
+#include <stdXmlParseContext.h>
+
+#include "HolidaysType.h"
+#include "PersonHolidaysType.h"
+#include "PersonType.h"
+
+/** Load the demo document */
+static HolidaysType* LoadDemo( stdXmlParseContext& context )
+{
+	HolidaysType* root = dynamic_cast< HolidaysType* >( context.LoadFile( DEMO_FILE ) );
+	BOOST_REQUIRE( root != NULL );
+	BOOST_REQUIRE( !root->GetPersonHolidays().empty() );
+
+	return root;
+}
+
+/** Write the given resource through a DOM tree, as the documents were written
+  * before the handlers could write them directly */
+static std::string DomSerialize( stdObject* resource )
+{
+	xmlDoc* doc = xmlNewDoc( (const xmlChar*) "1.0" );
+	xmlNode* root = stdXmlReader::Get()->WriteResource( resource );
+	BOOST_REQUIRE( root != NULL );
+	xmlDocSetRootElement( doc , root );
+
+	xmlChar* data;
+	int size;
+	xmlDocDumpMemory( doc , &data , &size );
+	std::string ret( (const char*) data , size );
+
+	xmlFree( data );
+	xmlFreeDoc( doc );
+
+	return ret;
+}
+
+/** The document written directly is the one written through a DOM tree */
+BOOST_AUTO_TEST_CASE( SameAsDom )
+{
+	stdXmlParseContext context;
+	HolidaysType* root = LoadDemo( context );
+
+	BOOST_CHECK_EQUAL( context.StringSerialize( root ) , DomSerialize( root ) );
+
+	delete root;
+}
+
+/** Special characters are escaped as in the DOM tree */
+BOOST_AUTO_TEST_CASE( Escaping )
+{
+	stdXmlParseContext context;
+	HolidaysType* root = LoadDemo( context );
+	PersonType& person = root->GetPersonHolidaysAt( 0 ).GetPerson();
+	person.SetFirstname( "A \"B\" & 'C' <D>\t\n" );
+	person.SetCity( "A & <B> ]]> \"C\"\r\n\xc3\xa9" );
+
+	BOOST_CHECK_EQUAL( context.StringSerialize( root ) , DomSerialize( root ) );
+
+	delete root;
+}
+
+/** Empty objects and documents written from the fragments of frozen objects are
+  * the ones written through a DOM tree */
+BOOST_AUTO_TEST_CASE( EmptyAndFrozen )
+{
+	stdXmlParseContext context;
+	HolidaysType empty;
+	BOOST_CHECK_EQUAL( context.StringSerialize( &empty ) , DomSerialize( &empty ) );
+
+	context.SetFragmentCaching( true );
+	HolidaysType* root = LoadDemo( context );
+	root->Freeze();
+	std::string dom = DomSerialize( root );
+	BOOST_CHECK_EQUAL( context.StringSerialize( root ) , dom );
+	BOOST_CHECK_EQUAL( context.StringSerialize( root ) , dom );
+
+	root->GetPersonHolidaysAt( 0 ).GetPerson().SetCity( "Lyon" );
+	BOOST_CHECK_EQUAL( context.StringSerialize( root ) , DomSerialize( root ) );
+
+	delete root;
+}
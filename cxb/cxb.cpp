@@ -38,9 +38,11 @@ int main(int argc, char **argv, char **ppenv) {
         ("interpreter,i",po::value<std::string>(), "Interpreter/Grammar XML file to use")
         ("namespace,n",po::value<std::string>(), "Namespace prefix to your objects to use")
         ("export-macro",po::value<std::string>(), "Export macro to use for your objects (default: DLLEXPORT)")
-        ("generator,g",po::value<std::string>(), "Generator Plugin to use (CPPObjects, CPPHandlers)")
+        ("generator,g",po::value<std::string>(), "Generator Plugin to use (CPPObjects, CPPHandlers, CPPBinary)")
         ("generator-templates,t",po::value<std::string>(), "Generator Plugin Templates file")
         ("output,o",po::value<std::string>(), "Output Directory")
+        ("index",po::value< std::vector<std::string> >()->composing(), "Index the items of an array by one of their properties for CPPObjects (element:property), can be repeated")
+        ("shared-arrays", "Share the arrays of CPPObjects between the copies of the objects until they are modified")
     ;
     
     po::variables_map vm;
@@ -118,6 +120,23 @@ int main(int argc, char **argv, char **ppenv) {
     gen_options.baseFile = file;
     gen_options.grammarFile = interpreter;
     gen_options.interpreterFile = templates;
+
+    if( vm.count("index") ) {
+        const std::vector<std::string>& indexes = vm["index"].as< std::vector<std::string> >();
+
+        for( unsigned int i = 0; i < indexes.size() ; ++i ) {
+            std::string::size_type sep = indexes[i].find( ':' );
+
+            if( sep == std::string::npos || sep == 0 || sep == indexes[i].size() - 1 ) {
+                std::cout << "Error invalid index " << indexes[i] << ", expected element:property..." << std::endl;
+                return 1;
+            }
+
+            gen_options.indexes[indexes[i].substr( 0 , sep )] = indexes[i].substr( sep + 1 );
+        }
+    }
+
+    gen_options.sharedArrays = vm.count("shared-arrays") > 0;
     
 
     CXBindingsGenerator* cxb = CXBindingsGeneratorFactory::Get()->CreateGenerator( generator );
@@ -260,6 +260,17 @@ public :
 	/** Get the base type */
 	std::string GetBaseType( const std::string& type );
 
+	/** Get the key used in generated code to dispatch on the given name using a switch.
+	  * Names are dispatched on their length and first character, this is the value of the
+	  * stdXML_NAME_KEY macro of libstdxmlbindings for the given name.
+	  */
+	unsigned long GetNameSwitchKey( const std::string& name );
+
+	/** Get the case label of the given name in generated switches, i.e : 
+	  * stdXML_NAME_KEY( 7 , 'a' ) for address
+	  */
+	std::string GetNameSwitchCase( const std::string& name );
+
 	/********************************************************************************************
 	  * MACROS MANAGEMENT
 	  * Macros are variables which can be found in any xml file under the form : $(mymacro)
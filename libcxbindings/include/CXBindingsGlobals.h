@@ -7,6 +7,7 @@
 #define CXBINDINGSGLOBALS_H
 
 
+#include <map>
 #include <set>
 #include <string>
 
@@ -72,7 +73,9 @@ struct CXBindingsGeneratorOptions
 	  * CONSTRUCTORS
 	  *******************************************************************************/
 	/** default constructor */
-	CXBindingsGeneratorOptions() {};
+	CXBindingsGeneratorOptions():
+		sharedArrays(false)
+	{};
 	
 	/** copy constructor */
 	CXBindingsGeneratorOptions( const CXBindingsGeneratorOptions& rhs ):
@@ -82,7 +85,9 @@ struct CXBindingsGeneratorOptions
 		ns( rhs.ns ),
 		grammarFile(rhs.grammarFile),
 		interpreterFile(rhs.interpreterFile),
-		baseFile(rhs.baseFile)
+		baseFile(rhs.baseFile),
+		indexes(rhs.indexes),
+		sharedArrays(rhs.sharedArrays)
 	{}
 
 	/** operator= overload */
@@ -96,6 +101,8 @@ struct CXBindingsGeneratorOptions
 		grammarFile = rhs.grammarFile;
 		interpreterFile = rhs.interpreterFile;
 		baseFile = rhs.baseFile;
+		indexes = rhs.indexes;
+		sharedArrays = rhs.sharedArrays;
 
 		return (*this);
 	}
@@ -107,6 +114,14 @@ struct CXBindingsGeneratorOptions
 	std::string grammarFile;
 	std::string interpreterFile;
 	std::string baseFile;
+
+	/** arrays whose items are indexed by one of their properties, the property
+	  * names by array element name */
+	std::map< std::string , std::string > indexes;
+
+	/** hold the arrays of generated objects in stdCowVector, so that they are
+	  * shared between the copies of the objects until they are modified */
+	bool sharedArrays;
 };
 
 /** define a map of strings */
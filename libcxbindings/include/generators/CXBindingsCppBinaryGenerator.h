@@ -0,0 +1,56 @@
+/**
+ * @file CXBindingsCppBinaryGenerator.h
+ * @brief main file for generating CPP compact binary encoders code in CXBindings
+ * @author Nicolas Macherey (nicolas.macherey@gmail.com)
+ * @version 10.4
+ */
+#ifndef CXBINDINGSCPPBINARYGENERATOR_H
+#define CXBINDINGSCPPBINARYGENERATOR_H
+
+/**
+  * @class CXBindingsCppBinaryGenerator
+  * @brief Main class for generating CPP compact binary encoders code in CXBindings
+  *
+  * The generated $(object)BinaryHandler's encode and decode the objects generated
+  * by CXBindingsCppObjectsGenerator in the compact binary format of the
+  * stdBinarySerializer. Objects are analysed the same way as for the xml handlers,
+  * only the templates and the dispatch of the readers differ : each member is a
+  * field numbered in its declaration order, members of the bases first, and the
+  * readers switch on these numbers.
+  *
+  * @author Nicolas Macherey (nicolas.macherey@gmail.com)
+  * @date 8-May-2010
+  */
+class CXBindingsCppBinaryGenerator : public CXBindingsCppHandlersGenerator
+{
+	DECLARE_DYNAMIC_CLASS_CXBINDINGS(CXBindingsCppBinaryGenerator)
+
+public :
+
+	/** Default constructor */
+	CXBindingsCppBinaryGenerator():
+		CXBindingsCppHandlersGenerator()
+	{};
+
+	/** destructor */
+	virtual ~CXBindingsCppBinaryGenerator();
+
+protected :
+
+	/** Handlers are named $(object)BinaryHandler */
+	virtual std::string GetHandlerSuffix() const {return "BinaryHandler";};
+
+	/** Handlers are generated in include/binary and src/binary */
+	virtual std::string GetHandlerDirectory() const {return "binary";};
+
+	/** Readers are dispatched on the member field number */
+	virtual void DoAddReaderFor( CXBindingsNameSwitchInfo& info , const std::string& name , const std::string& type , const std::string& content );
+
+	/** Attributes and properties are read in the same switch */
+	virtual void DoSetReadersMacros( const CXBindingsHandlerFileParametersMacros& params );
+
+	/** Include the object and its binary handler */
+	virtual std::string DoCreateIncludeFor( const std::string& object );
+};
+
+#endif
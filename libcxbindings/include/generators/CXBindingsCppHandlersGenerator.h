@@ -93,6 +93,72 @@ struct CXBindingsHandlerFileInfo
   */
 typedef std::map< std::string , CXBindingsHandlerFileInfo > CXBindingsHandlerFileInfoMap;
 
+/** @struct CXBindingsNameSwitchInfo
+  * @brief main structure for storing code snippets dispatched on names.
+  * Generated handlers switch on the length and first character of a name (see 
+  * CXBindingsGenerator::GetNameSwitchKey) so that each name is only compared
+  * with the names sharing the same key instead of all the known ones.
+  */
+struct CXBindingsNameSwitchInfo
+{
+	/** default ctor */
+	CXBindingsNameSwitchInfo(){};
+
+	/** copy ctor */
+	CXBindingsNameSwitchInfo(const CXBindingsNameSwitchInfo& rhs):
+		labels( rhs.labels ),
+		cases( rhs.cases ),
+		defaultCase( rhs.defaultCase )
+	{};
+
+	/** assignment operator */
+	CXBindingsNameSwitchInfo& operator=( const CXBindingsNameSwitchInfo& rhs )
+	{
+		labels = rhs.labels;
+		cases = rhs.cases;
+		defaultCase = rhs.defaultCase;
+		return (*this);
+	};
+
+	/** append operator, snippets of rhs are added after ours in each case */
+	CXBindingsNameSwitchInfo& operator+=( const CXBindingsNameSwitchInfo& rhs )
+	{
+		std::map< unsigned long , std::string >::const_iterator it = rhs.cases.begin();
+		for( ; it != rhs.cases.end() ; ++it ) {
+			labels[it->first] = rhs.labels.find(it->first)->second;
+			AddCase( it->first , it->second );
+		}
+
+		defaultCase += rhs.defaultCase;
+		return (*this);
+	};
+
+	/** add a snippet to the case of the given key. The snippets of a case are if
+	  * statements testing the name, they are chained with else so that the
+	  * snippets of the default case can be run when none of them matches
+	  */
+	void AddCase( unsigned long key , const std::string& content )
+	{
+		std::string& code = cases[key];
+		size_t start = content.find_first_not_of( " \t\n" );
+
+		if( code.empty() || start == std::string::npos ) {
+			code += content;
+			return;
+		}
+
+		code.erase( code.find_last_not_of( " \t\n" ) + 1 );
+		code += "\n\t\telse " + content.substr( start );
+	};
+
+	/** case labels by key */
+	std::map< unsigned long , std::string > labels;
+	/** snippets by key */
+	std::map< unsigned long , std::string > cases;
+	/** snippets which are not dispatched on a name */
+	std::string defaultCase;
+};
+
 /** define a structure for handling parameters macros */
 struct CXBindingsHandlerFileParametersMacros
 {
@@ -104,7 +170,9 @@ struct CXBindingsHandlerFileParametersMacros
 		attribute_readers( rhs.attribute_readers ),
 		attribute_writers( rhs.attribute_writers ),
 		property_readers( rhs.property_readers ),
-		property_writers( rhs.property_writers )
+		property_writers( rhs.property_writers ),
+		differs( rhs.differs ),
+		patchers( rhs.patchers )
 	{};
 
 	/** assignment operator */
@@ -114,6 +182,8 @@ struct CXBindingsHandlerFileParametersMacros
 		attribute_writers = rhs.attribute_writers ;
 		property_readers = rhs.property_readers ;
 		property_writers = rhs.property_writers ;
+		differs = rhs.differs ;
+		patchers = rhs.patchers ;
 		
 		return (*this);
 	};
@@ -125,14 +195,20 @@ struct CXBindingsHandlerFileParametersMacros
 		attribute_writers += rhs.attribute_writers ;
 		property_readers += rhs.property_readers ;
 		property_writers += rhs.property_writers ;
+		differs += rhs.differs ;
+		patchers += rhs.patchers ;
 		
 		return (*this);
 	};
 
-	std::string attribute_readers;
+	CXBindingsNameSwitchInfo attribute_readers;
 	std::string attribute_writers;
-	std::string property_readers;
+	CXBindingsNameSwitchInfo property_readers;
 	std::string property_writers;
+	/** snippets writing the differences of the members, for the templates providing them */
+	std::string differs;
+	/** snippets applying the differences of the members, dispatched as the readers */
+	CXBindingsNameSwitchInfo patchers;
 };
 
 /**
@@ -150,7 +226,8 @@ public :
 	
 	/** Default constructor */
 	CXBindingsCppHandlersGenerator():
-		CXBindingsGenerator()
+		CXBindingsGenerator(),
+		m_field(0)
 	{};
 
 	/** destructor */
@@ -164,7 +241,60 @@ public :
 	 */
 	virtual bool DoGenerateCode( CXBindingsGeneratorOptions& options );
 
-private :
+protected :
+
+	/** Get the suffix appended to the object names for naming the generated
+	  * handlers and their files
+	  */
+	virtual std::string GetHandlerSuffix() const {return "XmlHandler";};
+
+	/** Get the sub directory of include and src in which handlers are generated */
+	virtual std::string GetHandlerDirectory() const {return "handlers";};
+
+	/** Add the reader of the given member to the readers of the object.
+	  * Readers are dispatched on the member name except the ones of any
+	  * elements which cannot be.
+	  * @param info [out] readers of the object
+	  * @param name member name
+	  * @param type member type as used for finding the reader template
+	  * @param content reader snippet
+	  */
+	virtual void DoAddReaderFor( CXBindingsNameSwitchInfo& info , const std::string& name , const std::string& type , const std::string& content );
+
+	/** Set the objects_attribute_readers and objects_property_readers macros
+	  * from the readers of the object members
+	  */
+	virtual void DoSetReadersMacros( const CXBindingsHandlerFileParametersMacros& params );
+
+	/** Add the differ and the patcher of the current member to the given parameters,
+	  * nothing is done if the templates file does not provide them
+	  * @param parameters [out] parameters of the object
+	  * @param prefix prefix of the templates, property_ or attribute_
+	  * @param name member name
+	  * @param type member type as used for finding the templates
+	  */
+	void DoAddDeltaTemplatesFor( CXBindingsHandlerFileParametersMacros& parameters , const std::string& prefix , const std::string& name , const std::string& type );
+
+	/** Expand the src parts of the given template
+	  * @return the expanded content, empty if the template does not exist
+	  */
+	std::string DoExpandSourceTemplate( const std::string& name );
+
+	/** Number the next member of the current object and return its number */
+	std::string DoCreateFieldNumber();
+
+	/** Get the index of the given name in the names registered by the handler
+	  * of the current object, the name is added if needed.
+	  */
+	std::string DoCreateNameIndex( const std::string& name );
+
+	/** Get the initializer of the array of names registered by the handler of
+	  * the current object.
+	  */
+	std::string DoCreateNamesList();
+
+	/** Get the include directive of the given object in the handler sources */
+	virtual std::string DoCreateIncludeFor( const std::string& object );
 	
 	/** This method will generate the code for the given grammar 
 	  * in the global scope, the global scope generator is a global file
@@ -214,6 +344,27 @@ private :
 	  * @param parameters [out] output structure containing basic macros for the parameters list
 	  */
 	void DoCreateParametersMacrosFor( CXBindingsHandlerFileInfo& file , CXBindingsHandlerFileParametersMacros& parameters , CXBindingsGeneratorOptions& options );
+
+	/** Build the cases of a switch on stdXmlNameKey from the given snippets
+	  * @param info snippets grouped by name keys
+	  * @param indent indentation of the case labels
+	  * @return the generated cases
+	  */
+	std::string DoCreateNameSwitchFor( const CXBindingsNameSwitchInfo& info , const std::string& indent );
+
+	/** Add the given snippet to the case of the given name
+	  * @param info [out] snippets grouped by name keys
+	  * @param name name the snippet is dispatched on
+	  * @param content snippet to add
+	  */
+	void DoAddNameSwitchCase( CXBindingsNameSwitchInfo& info , const std::string& name , const std::string& content );
+
+	/** Build the loop decoding the attributes of the handled node from the attribute
+	  * readers, the loop is empty if the object has no attributes.
+	  * @param info attribute readers grouped by name keys
+	  * @return the generated loop
+	  */
+	std::string DoCreateAttributeReadersFor( const CXBindingsNameSwitchInfo& info );
 	
 	/** Get the property list for all childrens 
 	  * @param local_includes [out] array string containing includes for the given file
@@ -236,11 +387,19 @@ private :
 	 */
 	CXBindingsHandlerFileInfo DoGenerateCategoryCodeFor( CXBindingsCategoryInfo& categoryInfo , CXBindings& grammar , CXBindingsGeneratorOptions& options );
 
-private :
+protected :
 
 	CXBindingsHandlerFileInfoMap m_objectInfos;
 	CXBindingsHandlerFileInfo m_globalInfo;
 	CXBindingsStringStringMap m_types;
+
+	/** number of the last member field of the current object, members are
+	  * numbered from 1 in their order, members of the bases first.
+	  */
+	unsigned int m_field;
+
+	/** element and attribute names read by the handler of the current object */
+	CXBindingsArrayString m_names;
 };
 
 
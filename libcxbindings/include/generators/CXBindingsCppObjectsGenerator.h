@@ -113,7 +113,13 @@ struct CXBindingsFileParametersMacros
 		parameters_default_init_list( rhs.parameters_default_init_list ),
 		parameters_copy_list( rhs.parameters_copy_list ),
 		parameters_eqop_list( rhs.parameters_eqop_list ),
+		parameters_move_list( rhs.parameters_move_list ),
+		parameters_moveop_list( rhs.parameters_moveop_list ),
 		parameters_eqeqop_list( rhs.parameters_eqeqop_list ),
+		parameters_lazy_list( rhs.parameters_lazy_list ),
+		parameters_reset_list( rhs.parameters_reset_list ),
+		parameters_hash_list( rhs.parameters_hash_list ),
+		parameters_freeze_list( rhs.parameters_freeze_list ),
 		parameters_property_table(rhs.parameters_property_table)
 	{};
 
@@ -128,7 +134,13 @@ struct CXBindingsFileParametersMacros
 		parameters_default_init_list = rhs.parameters_default_init_list;
 		parameters_copy_list = rhs.parameters_copy_list ;
 		parameters_eqop_list = rhs.parameters_eqop_list ;
+		parameters_move_list = rhs.parameters_move_list ;
+		parameters_moveop_list = rhs.parameters_moveop_list ;
 		parameters_eqeqop_list = rhs.parameters_eqeqop_list;
+		parameters_lazy_list = rhs.parameters_lazy_list;
+		parameters_reset_list = rhs.parameters_reset_list;
+		parameters_hash_list = rhs.parameters_hash_list;
+		parameters_freeze_list = rhs.parameters_freeze_list;
 		parameters_property_table = rhs.parameters_property_table;
 		
 		return (*this);
@@ -142,7 +154,13 @@ struct CXBindingsFileParametersMacros
 	std::string parameters_default_init_list;
 	std::string parameters_copy_list;
 	std::string parameters_eqop_list;
+	std::string parameters_move_list;
+	std::string parameters_moveop_list;
 	std::string parameters_eqeqop_list;
+	std::string parameters_lazy_list;
+	std::string parameters_reset_list;
+	std::string parameters_hash_list;
+	std::string parameters_freeze_list;
 	std::string parameters_property_table;
 };
 
@@ -250,6 +268,26 @@ private :
 	 */
 	CXBindingsFileInfo DoGenerateCategoryCodeFor( CXBindingsCategoryInfo& categoryInfo , CXBindings& grammar , CXBindingsGeneratorOptions& options );
 
+	/** Set the macros maintaining the index of the given array, see the indexes
+	  * member of CXBindingsGeneratorOptions
+	  * @param name element name of the array
+	  * @param itemType type of the array items
+	  * @param isArray false if the property is not an array, it is then never indexed
+	  * @param options generator options
+	  * @return the array_property_finder template if the array is indexed, NULL otherwise
+	  */
+	CXBindingsGeneratorFileTemplate* DoSetArrayIndexMacros( const std::string& name , const std::string& itemType , bool isArray , CXBindingsGeneratorOptions& options );
+
+	/** Set the macros declaring and accessing the member of the current property,
+	  * arrays are held in stdCowVector when the sharedArrays option is set
+	  * @param isArray false if the property is not an array
+	  * @param options generator options
+	  */
+	void DoSetMemberMacros( bool isArray , CXBindingsGeneratorOptions& options );
+
+	/** Append the code of the given template to the given file information */
+	void DoAppendTemplateCode( CXBindingsGeneratorFileTemplate* fileTemplate , CXBindingsFileInfo& res );
+
 private :
 
 	CXBindingsFileInfoMap m_objectInfos;
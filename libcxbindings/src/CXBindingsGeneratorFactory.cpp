@@ -8,6 +8,8 @@
 #include <libxml/xpath.h>
 
 #include <stdio.h>
+#include <ctype.h>
+#include <sstream>
 #include <iostream>
 #include <vector>
 #include <map>
@@ -513,6 +515,30 @@ std::string CXBindingsGenerator::GetBaseType( const std::string& type ) {
 	return stdEmptyString;
 }
 
+unsigned long CXBindingsGenerator::GetNameSwitchKey( const std::string& name )
+{
+	if( name.empty() )
+		return 0;
+
+	return ( (unsigned long) name.size() << 8 ) | (unsigned char) name[0];
+}
+
+std::string CXBindingsGenerator::GetNameSwitchCase( const std::string& name )
+{
+	std::stringstream strm;
+	strm << "stdXML_NAME_KEY( " << name.size() << " , ";
+
+	unsigned char first = name.empty() ? 0 : (unsigned char) name[0];
+
+	if( isalnum( first ) || first == '_' )
+		strm << "'" << (char) first << "'";
+	else
+		strm << "0x" << std::hex << (unsigned int) first;
+
+	strm << " )";
+	return strm.str();
+}
+
 std::string CXBindingsGenerator::GetRealType( const std::string& typeBase , CXBindingsGeneratorOptions& options )
 {
     std::string type = typeBase;
@@ -65,7 +65,7 @@ CXBindingsInterpreterInfo CXBindingsInterpreter::DoExtractObjectsInformation( co
 	xmlInitParser();
 
 	/* Load XML document */
-	m_doc = xmlParseFile(cxcU2C(file));
+	m_doc = xmlReadFile( cxcU2C(file) , NULL , XML_PARSE_COMPACT | XML_PARSE_NOBLANKS );
 
 	if (m_doc == NULL)
 		CXB_THROW( "Error cannot open your document !")  ;
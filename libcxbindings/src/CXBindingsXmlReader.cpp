@@ -53,7 +53,7 @@ CXBindingsObjectBase* CXBindingsXmlReader::LoadFile( const std::string& file )
 {
 	//wxLogMessage( "Opening File : ") + file  ;
 	
-	m_doc = xmlParseFile( cxcU2C(file) );
+	m_doc = xmlReadFile( cxcU2C(file) , NULL , XML_PARSE_COMPACT | XML_PARSE_NOBLANKS );
 	
 	if( m_doc == NULL )
 		CXB_THROW("Error cannot open document!") ;
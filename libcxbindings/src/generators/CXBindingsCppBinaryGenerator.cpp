@@ -0,0 +1,59 @@
+/**
+ * @file CXBindingsCppBinaryGenerator.cpp
+ * @brief main file for generating CPP compact binary encoders code in CXBindings
+ * @author Nicolas Macherey (nicolas.macherey@gmail.com)
+ * @version 10.4
+ */
+#include <libxml/xmlreader.h>
+#include <libxml/xpath.h>
+
+#include <stdio.h>
+#include <iostream>
+#include <vector>
+#include <map>
+#include <stack>
+#include <algorithm>
+
+#include "CXBindingsDefinitions.h"
+#include "CXBindingsGlobals.h"
+#include "CXBindingsException.h"
+#include "CXBindingsExpressionParser.h"
+#include "CXBindings.h"
+#include "CXBindingsInterpreter.h"
+#include "CXBindingsGeneratorFile.h"
+#include "CXBindingsXmlReader.h"
+#include "CXBindingsGeneratorFactory.h"
+
+#include "generators/CXBindingsCppHandlersGenerator.h"
+#include "generators/CXBindingsCppBinaryGenerator.h"
+
+/* Implements CXBindingsObjectBase RTTI information */
+IMPLEMENT_DYNAMIC_CLASS_CXBINDINGS( CXBindingsCppBinaryGenerator , CXBindingsCppHandlersGenerator );
+
+CXBINDINGS_REGISTER_GENERATOR( CXBindingsCppBinaryGenerator, "CPPBinary" , "Generate CPP compact binary encoders from CXBindings definition")  ;
+
+CXBindingsCppBinaryGenerator::~CXBindingsCppBinaryGenerator()
+{
+
+}
+
+void CXBindingsCppBinaryGenerator::DoAddReaderFor( CXBindingsNameSwitchInfo& info , const std::string& name , const std::string& , const std::string& content )
+{
+	/* m_field is the number of the member being generated */
+	info.labels[m_field] = GetMacro( "field" ) + " /* " + name + " */";
+	info.cases[m_field] += content;
+}
+
+void CXBindingsCppBinaryGenerator::DoSetReadersMacros( const CXBindingsHandlerFileParametersMacros& params )
+{
+	CXBindingsNameSwitchInfo readers( params.property_readers );
+	readers += params.attribute_readers;
+
+	SetMacro( "objects_attribute_readers" , "" ) ;
+	SetMacro( "objects_property_readers" , DoCreateNameSwitchFor( readers , "\t\t" )) ;
+}
+
+std::string CXBindingsCppBinaryGenerator::DoCreateIncludeFor( const std::string& object )
+{
+	return "#include \"" + object + ".h\"\n#include \"binary/" + object + GetHandlerSuffix() + ".h\"\n";
+}
@@ -13,10 +13,12 @@
 #include <vector>
 #include <map>
 #include <stack>
+#include <sstream>
 #include <algorithm>
 
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/algorithm/string/replace.hpp>
+#include <boost/algorithm/string/trim.hpp>
 
 #include "CXBindingsDefinitions.h"
 #include "CXBindingsGlobals.h"
@@ -77,8 +79,8 @@ bool CXBindingsCppHandlersGenerator::DoGenerateCode( CXBindingsGeneratorOptions&
 	
 	/** The last step is to generate the globals file and the other files for given objects */
 	
-	std::string hdrDir = options.genDir + "/include/handlers" ;
-	std::string srcDir = options.genDir + "/src/handlers" ;
+	std::string hdrDir = options.genDir + "/include/" + GetHandlerDirectory() ;
+	std::string srcDir = options.genDir + "/src/" + GetHandlerDirectory() ;
 	CXBindingsMakeDirRecursively(hdrDir+"/") ;
 	CXBindingsMakeDirRecursively(srcDir+"/") ;
 	
@@ -102,8 +104,8 @@ bool CXBindingsCppHandlersGenerator::DoGenerateCode( CXBindingsGeneratorOptions&
 		}
 	}
 	
-	hdrDir = options.genDir + "/include/handlers" ;
-	srcDir = options.genDir + "/src/handlers" ;
+	hdrDir = options.genDir + "/include/" + GetHandlerDirectory() ;
+	srcDir = options.genDir + "/src/" + GetHandlerDirectory() ;
 	
 	filename = options.ns + "_globals" ;
 	CXBindingsHandlerFileInfoMap::iterator it = m_objectInfos.begin();
@@ -111,8 +113,8 @@ bool CXBindingsCppHandlersGenerator::DoGenerateCode( CXBindingsGeneratorOptions&
 	{
 		if( m_objectFiles[it->first]!=filename && !m_objectFiles[it->first].empty() )
 		{
-			std::string srcFile = srcDir + "/" + m_objectFiles[it->first] + "XmlHandler"  + ".cpp" ;
-			std::string hdrFile = hdrDir + "/" + m_objectFiles[it->first] + "XmlHandler"  + ".h" ;
+			std::string srcFile = srcDir + "/" + m_objectFiles[it->first] + GetHandlerSuffix()  + ".cpp" ;
+			std::string hdrFile = hdrDir + "/" + m_objectFiles[it->first] + GetHandlerSuffix()  + ".h" ;
 			
 			SaveFile( srcFile , it->second.srcInfo );
 			SaveFile( hdrFile , it->second.headerInfo );
@@ -144,7 +146,7 @@ void CXBindingsCppHandlersGenerator::DoGenerateCodeFor( CXBindingsObjectInfo& ob
 	// @todo here the file is not preoprely set
 	/* First set up some macros for the given file */
 	// filename macros
-	std::string filename = objectName + "XmlHandler" ;
+	std::string filename = objectName + GetHandlerSuffix() ;
 	SetMacro( "filename" , filename) ;
 
 	// STEP 1 : CHECK CHILD CONTAINERS AND RULES
@@ -170,6 +172,8 @@ void CXBindingsCppHandlersGenerator::DoGenerateCodeFor( CXBindingsObjectInfo& ob
 
 	// Finally build the missing macrods for doc comments and other parameters info
 	CXBindingsHandlerFileParametersMacros params;
+	m_field = 0;
+	m_names.clear();
 	
 	/* once all parameters list have been generated, we need to create the macros of derived
 	 * objects. This is very important in order to treat the inherit template from the various
@@ -187,10 +191,12 @@ void CXBindingsCppHandlersGenerator::DoGenerateCodeFor( CXBindingsObjectInfo& ob
 	
 	DoCreateParametersMacrosFor( objectFileInfo , params , options );
 
-	SetMacro( "objects_attribute_readers" , params.attribute_readers) ;
+	DoSetReadersMacros( params );
+	SetMacro( "object_names" , DoCreateNamesList() ) ;
 	SetMacro( "objects_attribute_writers" , params.attribute_writers) ;
-	SetMacro( "objects_property_readers" , params.property_readers) ;
 	SetMacro( "objects_property_writers" , params.property_writers) ;
+	SetMacro( "objects_differs" , params.differs) ;
+	SetMacro( "objects_patchers" , DoCreateNameSwitchFor( params.patchers , "\t\t\t" )) ;
 	
 	
 	/* The next step is very important ! 
@@ -279,6 +285,8 @@ void CXBindingsCppHandlersGenerator::DoCreateParametersMacrosFor( CXBindingsHand
 		SetMacro( "name_extension", nameExt) ;
 		SetMacro( "name" , pName) ;
 		SetMacro( "type" , pType) ;
+		SetMacro( "field" , DoCreateFieldNumber() ) ;
+		SetMacro( "name_index" , DoCreateNameIndex( pName ) ) ;
 	    
         std::string ot = pType;
 		/* Here we have to get the types of each properties and if it's not an object
@@ -312,7 +320,7 @@ void CXBindingsCppHandlersGenerator::DoCreateParametersMacrosFor( CXBindingsHand
 			DoReplaceMacros( content );
 
 			if( objects[j].GetFile() =="src")    {
-				parameters.property_readers += content;
+				DoAddReaderFor( parameters.property_readers , pName , pType , content );
 			}
 		}
 		
@@ -327,6 +335,7 @@ void CXBindingsCppHandlersGenerator::DoCreateParametersMacrosFor( CXBindingsHand
 				parameters.property_writers += content;
 			}
 		}
+		DoAddDeltaTemplatesFor( parameters , "property_" , pName , pType );
 	}
 	
 	for( unsigned int i = 0; i < file.attributes.size() ; ++i )
@@ -342,6 +351,8 @@ void CXBindingsCppHandlersGenerator::DoCreateParametersMacrosFor( CXBindingsHand
 		SetMacro( "name_extension" , nameExt) ;
 		SetMacro( "name" , pName) ;
 		SetMacro( "type" , pType) ;
+		SetMacro( "field" , DoCreateFieldNumber() ) ;
+		SetMacro( "name_index" , DoCreateNameIndex( pName ) ) ;
 		
 		/* Here we have to get the types of each attributes and if it's not an object
 		 * get the "real" type of the given attributes (i.e : a typedef or an enumeration)
@@ -374,7 +385,7 @@ void CXBindingsCppHandlersGenerator::DoCreateParametersMacrosFor( CXBindingsHand
 			DoReplaceMacros( content );
 
 			if( objects[j].GetFile() =="src")    {
-				parameters.attribute_readers += content;
+				DoAddReaderFor( parameters.attribute_readers , pName , pType , content );
 			}
 		}
 		
@@ -389,10 +400,155 @@ void CXBindingsCppHandlersGenerator::DoCreateParametersMacrosFor( CXBindingsHand
 				parameters.attribute_writers += content;
 			}
 		}
+		DoAddDeltaTemplatesFor( parameters , "attribute_" , pName , pType );
 	}
 
 }
 
+void CXBindingsCppHandlersGenerator::DoAddReaderFor( CXBindingsNameSwitchInfo& info , const std::string& name , const std::string& type , const std::string& content )
+{
+	/* readers of any elements cannot be dispatched on their name */
+	if( boost::algorithm::ends_with( type , "any" ) )
+		info.defaultCase += content;
+	else
+		DoAddNameSwitchCase( info , name , content );
+}
+
+void CXBindingsCppHandlersGenerator::DoSetReadersMacros( const CXBindingsHandlerFileParametersMacros& params )
+{
+	SetMacro( "objects_attribute_readers" , DoCreateAttributeReadersFor( params.attribute_readers )) ;
+	SetMacro( "objects_property_readers" , DoCreateNameSwitchFor( params.property_readers , "\t\t" )) ;
+}
+
+void CXBindingsCppHandlersGenerator::DoAddDeltaTemplatesFor( CXBindingsHandlerFileParametersMacros& parameters , const std::string& prefix , const std::string& name , const std::string& type )
+{
+	parameters.differs += DoExpandSourceTemplate( prefix + "differ_" + type );
+
+	std::string patcher = DoExpandSourceTemplate( prefix + "patcher_" + type );
+
+	if( !patcher.empty() )
+		DoAddReaderFor( parameters.patchers , name , type , patcher );
+}
+
+std::string CXBindingsCppHandlersGenerator::DoExpandSourceTemplate( const std::string& name )
+{
+	std::string ret;
+	CXBindingsGeneratorFileTemplate* tmpl = m_genfile->FindTemplate( name );
+
+	if( tmpl == NULL )
+		return ret;
+
+	CXBindingsArrayGrammarGeneratorFileObjectPart& objects = tmpl->GetObjects();
+
+	for( unsigned int j = 0; j < objects.size() ; ++j ) {
+		std::string content = objects[j].GetContent();
+		DoReplaceMacros( content );
+
+		if( objects[j].GetFile() =="src")
+			ret += content;
+	}
+
+	return ret;
+}
+
+std::string CXBindingsCppHandlersGenerator::DoCreateFieldNumber()
+{
+	std::stringstream strm;
+	strm << ++m_field;
+	return strm.str();
+}
+
+std::string CXBindingsCppHandlersGenerator::DoCreateNameIndex( const std::string& name )
+{
+	CXBindingsArrayString::iterator it = std::find( m_names.begin() , m_names.end() , name );
+	size_t index = it - m_names.begin();
+
+	if( it == m_names.end() )
+		m_names.push_back( name );
+
+	std::stringstream strm;
+	strm << index;
+	return strm.str();
+}
+
+std::string CXBindingsCppHandlersGenerator::DoCreateNamesList()
+{
+	std::string ret;
+
+	for( unsigned int i = 0; i < m_names.size() ; ++i )
+		ret += "\t\"" + m_names[i] + "\" ,\n";
+
+	return ret;
+}
+
+std::string CXBindingsCppHandlersGenerator::DoCreateIncludeFor( const std::string& object )
+{
+	return "#include \"" + object + ".h\"\n";
+}
+
+std::string CXBindingsCppHandlersGenerator::DoCreateNameSwitchFor( const CXBindingsNameSwitchInfo& info , const std::string& indent )
+{
+	std::string ret;
+	std::string defaultCase = boost::algorithm::trim_right_copy( info.defaultCase );
+
+	std::map< unsigned long , std::string >::const_iterator it = info.cases.begin();
+	for( ; it != info.cases.end() ; ++it ) {
+		ret += indent + "case " + info.labels.find( it->first )->second + " :";
+		ret += boost::algorithm::trim_right_copy( it->second ) + "\n";
+
+		/* names sharing the key of known names are handled by the default case */
+		if( !defaultCase.empty() )
+			ret += indent + "else {" + defaultCase + "\n" + indent + "}\n";
+
+		ret += indent + "\tbreak;\n";
+	}
+
+	if( !defaultCase.empty() ) {
+		ret += indent + "default :";
+		ret += defaultCase + "\n";
+		ret += indent + "\tbreak;\n";
+	}
+
+	return ret;
+}
+
+void CXBindingsCppHandlersGenerator::DoAddNameSwitchCase( CXBindingsNameSwitchInfo& info , const std::string& name , const std::string& content )
+{
+	unsigned long key = GetNameSwitchKey( name );
+
+	if( info.labels.find( key ) == info.labels.end() )
+		info.labels[key] = GetNameSwitchCase( name );
+
+	info.labels[key] += " /* " + name + " */";
+	info.AddCase( key , content );
+}
+
+std::string CXBindingsCppHandlersGenerator::DoCreateAttributeReadersFor( const CXBindingsNameSwitchInfo& info )
+{
+	if( info.cases.empty() && info.defaultCase.empty() )
+		return "";
+
+	CXBindingsGeneratorFileTemplate* loop = m_genfile->FindTemplate( "attribute_readers" );
+
+	if( loop == NULL )
+		CXB_THROW( "Error cannot find attribute_readers template" );
+
+	SetMacro( "attribute_cases" , DoCreateNameSwitchFor( info , "\t\t" ) );
+
+	std::string ret;
+	CXBindingsArrayGrammarGeneratorFileObjectPart& objects = loop->GetObjects();
+
+	for( unsigned int j = 0; j < objects.size() ; ++j ) {
+		std::string content = objects[j].GetContent();
+		DoReplaceMacros( content );
+
+		if( objects[j].GetFile() =="src")
+			ret += content;
+	}
+
+	return ret;
+}
+
 CXBindingsHandlerFileInfo CXBindingsCppHandlersGenerator::DoGenerateRuleCodeFor( CXBindingsChildContainerInfo& childContainer , CXBindingsRuleInfo& ruleInfo , CXBindings& grammar , CXBindingsGeneratorOptions& options )
 {
 	CXBindingsHandlerFileInfo res;
@@ -650,17 +806,17 @@ void CXBindingsCppHandlersGenerator::DoGetIncludesListFor( CXBindingsArrayString
 			currentObjects.erase(it);
 		}
 		
-		std::string inc = "#include \"" + pName + ".h\"\n" ;
+		std::string inc = DoCreateIncludeFor( pName ) ;
 		it = std::find( local_includes.begin(), local_includes.end(), inc );
 		if( it == local_includes.end() ) {
-			local_includes.push_back("#include \"" + pName + ".h\"\n") ;
+			local_includes.push_back( inc ) ;
 		}
 	}
 	
 	for( unsigned int i = 0; i < file.dependencies.size() ; ++i )
 	{
 		if( m_objectFiles[file.dependencies[i].second] != (options.ns + "_globals") && !m_objectFiles[file.dependencies[i].second].empty() )  {
-			std::string inc = "#include \"" + file.dependencies[i].second + ".h\"\n";
+			std::string inc = DoCreateIncludeFor( file.dependencies[i].second );
 
 			CXBindingsArrayString::iterator it = std::find( local_includes.begin(), local_includes.end(), inc );
 			if( it == local_includes.end() ) {
@@ -673,7 +829,7 @@ void CXBindingsCppHandlersGenerator::DoGetIncludesListFor( CXBindingsArrayString
 					currentObjects.erase(it);
 				}
 				
-				local_includes.push_back( "#include \"" + file.dependencies[i].second + ".h\"\n"  ) ;
+				local_includes.push_back( inc ) ;
 			}
 		}
 	}
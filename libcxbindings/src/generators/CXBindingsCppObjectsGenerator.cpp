@@ -231,6 +231,7 @@ void CXBindingsCppObjectsGenerator::DoGenerateCodeFor(
 	std::string object_bases_default_ctor;
         std::string object_bases_init_list;
 	std::string object_bases_copy_list;
+	std::string object_bases_move_list;
 	std::string object_bases_list;
 
 	for( unsigned int i = 0; i < objectFileInfo.bases.size() ; ++i ) {
@@ -246,7 +247,12 @@ void CXBindingsCppObjectsGenerator::DoGenerateCodeFor(
 		params.parameters_doc_list += localp.parameters_doc_list;
 		params.parameters_ctor_list += localp.parameters_ctor_list;
 		params.parameters_eqop_list += localp.parameters_eqop_list;
+		params.parameters_moveop_list += localp.parameters_moveop_list;
 		params.parameters_eqeqop_list = localp.parameters_eqeqop_list;
+		params.parameters_lazy_list += localp.parameters_lazy_list;
+		params.parameters_reset_list += localp.parameters_reset_list;
+		params.parameters_hash_list += localp.parameters_hash_list;
+		params.parameters_freeze_list += localp.parameters_freeze_list;
 
 		//wxLogMessage( localp.parameters_doc_list );
 		
@@ -255,6 +261,7 @@ void CXBindingsCppObjectsGenerator::DoGenerateCodeFor(
 			object_bases_list += " , "  + pName;
 			object_bases_default_ctor += ",\n\t\t" + pName + "()" ;
 			object_bases_copy_list += ",\n\t\t" + pName + "(rhs)" ;
+			object_bases_move_list += ",\n\t\t" + pName + "(std::move(rhs))" ;
 			object_bases_init_list += ",\n\t\t" + pName + "(" + localp.parameters_ctor_list2 + ")" ;
 		}
 		else {
@@ -262,6 +269,7 @@ void CXBindingsCppObjectsGenerator::DoGenerateCodeFor(
 			object_bases_list += pName;
 			object_bases_default_ctor += "\t\t" + pName + "()" ;
 			object_bases_copy_list += "\t\t" + pName + "(rhs)" ;
+			object_bases_move_list += "\t\t" + pName + "(std::move(rhs))" ;
 			object_bases_init_list += " \t\t" + pName + "(" + localp.parameters_ctor_list2 + ")" ;
 		}
 	}
@@ -270,6 +278,7 @@ void CXBindingsCppObjectsGenerator::DoGenerateCodeFor(
 		object_bases = "public $(base_object)" ;
 		object_bases_default_ctor = "\t\t$(base_object)()" ;
 		object_bases_copy_list = "\t\t$(base_object)()" ;
+		object_bases_move_list = "\t\t$(base_object)()" ;
 		object_bases_list = "$(base_object)" ;
 		object_bases_init_list = "\t\t$(base_object)()" ;
 	}
@@ -279,6 +288,24 @@ void CXBindingsCppObjectsGenerator::DoGenerateCodeFor(
 	SetMacro( "object_bases_default_ctor" , object_bases_default_ctor) ;
 	SetMacro( "object_bases_init_list" , object_bases_init_list) ;
 	SetMacro( "object_bases_copy_list" , object_bases_copy_list) ;
+	SetMacro( "object_bases_move_list" , object_bases_move_list) ;
+
+	/* the members whose loading has been deferred, the hash of the objects and the
+	 * bytes written for them are kept by the first generated class of the hierarchy,
+	 * derived classes share them.
+	 */
+	if( objectFileInfo.bases.empty() ) {
+		SetMacro( "object_lazy_member" , "$(lazy_member)" ) ;
+		SetMacro( "object_lazy_copy" , "$(lazy_copy)" ) ;
+		SetMacro( "object_lazy_move" , "$(lazy_move)" ) ;
+		SetMacro( "object_cache_member" , "$(cache_member)" ) ;
+	}
+	else {
+		SetMacro( "object_lazy_member" , stdEmptyString ) ;
+		SetMacro( "object_lazy_copy" , stdEmptyString ) ;
+		SetMacro( "object_lazy_move" , stdEmptyString ) ;
+		SetMacro( "object_cache_member" , stdEmptyString ) ;
+	}
 	
     DoCreateParametersMacrosFor( objectFileInfo , params , options );
 
@@ -292,7 +319,13 @@ void CXBindingsCppObjectsGenerator::DoGenerateCodeFor(
 	SetMacro( "parameters_default_init_list" , params.parameters_default_init_list ) ;
 	SetMacro( "parameters_copy_list" , params.parameters_copy_list ) ;
 	SetMacro( "parameters_eqop_list" , params.parameters_eqop_list ) ;
+	SetMacro( "parameters_move_list" , params.parameters_move_list ) ;
+	SetMacro( "parameters_moveop_list" , params.parameters_moveop_list ) ;
 	SetMacro( "parameters_eqeqop_list" , params.parameters_eqeqop_list ) ;
+	SetMacro( "parameters_lazy_list" , params.parameters_lazy_list ) ;
+	SetMacro( "parameters_reset_list" , params.parameters_reset_list ) ;
+	SetMacro( "parameters_hash_list" , params.parameters_hash_list ) ;
+	SetMacro( "parameters_freeze_list" , params.parameters_freeze_list ) ;
 	SetMacro( "parameters_property_table" , params.parameters_property_table ) ;
 	
 	if( params.parameters_doc_list.empty() ){
@@ -410,6 +443,24 @@ void CXBindingsCppObjectsGenerator::DoCreateParametersMacrosFor( CXBindingsFileI
 		DoReplaceMacros(str);
 		parameters.parameters_copy_list += str;
 		
+		str = GetMacro("var_move_composer") ;
+		DoReplaceMacros(str);
+		parameters.parameters_move_list += str;
+		
+		str = GetMacro("var_moveop_composer") ;
+		DoReplaceMacros(str);
+		parameters.parameters_moveop_list += str;
+		
+		/* assigning or resetting an indexed array invalidates its index */
+		bool indexed = options.indexes.find( pName ) != options.indexes.end() && boost::algorithm::starts_with( pType , "std::vector<" );
+
+		if( indexed ) {
+			str = GetMacro("var_index_reset_composer") ;
+			DoReplaceMacros(str);
+			parameters.parameters_eqop_list += str;
+			parameters.parameters_moveop_list += str;
+		}
+		
 		str = GetMacro("var_doc_composer") ;
 		DoReplaceMacros(str);
 		parameters.parameters_doc_list += str;
@@ -417,6 +468,28 @@ void CXBindingsCppObjectsGenerator::DoCreateParametersMacrosFor( CXBindingsFileI
 		str = GetMacro("var_property_composer") ;
 		DoReplaceMacros(str);
 		parameters.parameters_property_table += str;
+
+		str = GetMacro("var_lazy_composer") ;
+		DoReplaceMacros(str);
+		parameters.parameters_lazy_list += str;
+
+		str = GetMacro("var_reset_composer") ;
+		DoReplaceMacros(str);
+		parameters.parameters_reset_list += str;
+
+		if( indexed ) {
+			str = GetMacro("var_index_clear_composer") ;
+			DoReplaceMacros(str);
+			parameters.parameters_reset_list += str;
+		}
+
+		str = GetMacro("var_hash_composer") ;
+		DoReplaceMacros(str);
+		parameters.parameters_hash_list += str;
+
+		str = GetMacro("var_freeze_composer") ;
+		DoReplaceMacros(str);
+		parameters.parameters_freeze_list += str;
 		
 		if( i < file.properties.size()-1 )
 			parameters.parameters_property_table += "\n" ;
@@ -471,6 +544,10 @@ CXBindingsFileInfo CXBindingsCppObjectsGenerator::DoGenerateRuleCodeFor( CXBindi
 	SetMacro( "type" , typeExt ) ;
 	SetMacro( "real_type" , savedType)  ;
 
+	DoSetMemberMacros( arrayTemplate != NULL , options );
+
+	CXBindingsGeneratorFileTemplate* finderTemplate = DoSetArrayIndexMacros( ruleInfo.name.content , savedType , arrayTemplate != NULL , options );
+
 	if( ruleInfo.make == "import")    {
 		
 		// We have to add here all informations about the object from which this one is derived
@@ -582,6 +659,9 @@ CXBindingsFileInfo CXBindingsCppObjectsGenerator::DoGenerateRuleCodeFor( CXBindi
 		}
 	}
 
+	if( finderTemplate != NULL )
+		DoAppendTemplateCode( finderTemplate , res );
+
 	return res;
 
 }
@@ -674,6 +754,10 @@ CXBindingsFileInfo CXBindingsCppObjectsGenerator::DoGenerateRuleCodeFor( CXBindi
 	SetMacro( "real_type" , savedType)  ;
 	SetMacro( "variable" , ruleInfo.variable.content)  ;
 
+	DoSetMemberMacros( arrayTemplate != NULL , options );
+
+	CXBindingsGeneratorFileTemplate* finderTemplate = DoSetArrayIndexMacros( ruleInfo.name.content , savedType , arrayTemplate != NULL , options );
+
 	CXBindingsGeneratorFileTemplate* rTemplate = m_genfile->FindTemplate( ruleInfo.make );
 
 	if( rTemplate == NULL )
@@ -731,22 +815,138 @@ CXBindingsFileInfo CXBindingsCppObjectsGenerator::DoGenerateRuleCodeFor( CXBindi
 		}
 	}
 
+	if( finderTemplate != NULL )
+		DoAppendTemplateCode( finderTemplate , res );
+
 	return res;
 	
 }
 
+/** Find the type of the given property in the given object or in its bases */
+static bool DoFindPropertyType( const CXBindingsFileInfo& info , const std::string& property , std::string& type )
+{
+	for( unsigned int i = 0; i < info.properties.size() ; ++i ) {
+		if( info.properties[i].first == property ) {
+			type = info.properties[i].second;
+			return true;
+		}
+	}
+
+	for( unsigned int i = 0; i < info.bases.size() ; ++i )
+		if( DoFindPropertyType( info.bases[i].second , property , type ) )
+			return true;
+
+	return false;
+}
+
+void CXBindingsCppObjectsGenerator::DoSetMemberMacros( bool isArray , CXBindingsGeneratorOptions& options )
+{
+	if( isArray && options.sharedArrays ) {
+		SetMacro( "member_type" , "$(member_shared_type)" ) ;
+		SetMacro( "member_read" , "$(member_shared_read)" ) ;
+		SetMacro( "member_write" , "$(member_shared_write)" ) ;
+	}
+	else {
+		SetMacro( "member_type" , "$(member_plain_type)" ) ;
+		SetMacro( "member_read" , "$(member_plain)" ) ;
+		SetMacro( "member_write" , "$(member_plain)" ) ;
+	}
+}
+
+CXBindingsGeneratorFileTemplate* CXBindingsCppObjectsGenerator::DoSetArrayIndexMacros( const std::string& name , const std::string& itemType , bool isArray , CXBindingsGeneratorOptions& options )
+{
+	SetMacro( "array_index_add" , stdEmptyString ) ;
+	SetMacro( "array_index_erase" , stdEmptyString ) ;
+	SetMacro( "array_index_insert_at" , stdEmptyString ) ;
+	SetMacro( "array_index_reset" , stdEmptyString ) ;
+	SetMacro( "array_index_lend" , stdEmptyString ) ;
+	SetMacro( "array_find_index" , "$(scan_find_index)" ) ;
+
+	std::map< std::string , std::string >::iterator it = options.indexes.find( name );
+
+	if( !isArray || it == options.indexes.end() )
+		return NULL;
+
+	std::string property = it->second;
+	std::string propertyType;
+	CXBindingsFileInfoMap::iterator oi = m_objectInfos.find( itemType );
+
+	if( oi == m_objectInfos.end() || !DoFindPropertyType( oi->second , property , propertyType ) )
+		CXB_THROW( "Error cannot index " + name + " by " + property + " , " + itemType + " has no such property" ) ;
+
+	CXBindingsGeneratorFileTemplate* finderTemplate = m_genfile->FindTemplate( "array_property_finder" );
+
+	if( finderTemplate == NULL )
+		CXB_THROW( "Error cannot find template : array_property_finder" ) ;
+
+	SetMacro( "property" , property ) ;
+	SetMacro( "property_extension" , GetPropertyExtension( property , options ) ) ;
+	SetMacro( "property_type" , propertyType ) ;
+
+	SetMacro( "array_index_add" , "$(index_add)" ) ;
+	SetMacro( "array_index_erase" , "$(index_erase)" ) ;
+	SetMacro( "array_index_insert_at" , "$(index_insert_at)" ) ;
+	SetMacro( "array_index_reset" , "$(index_reset)" ) ;
+	SetMacro( "array_index_lend" , "$(index_lend)" ) ;
+	SetMacro( "array_find_index" , "$(index_find_index)" ) ;
+
+	return finderTemplate;
+}
+
+void CXBindingsCppObjectsGenerator::DoAppendTemplateCode( CXBindingsGeneratorFileTemplate* fileTemplate , CXBindingsFileInfo& res )
+{
+	CXBindingsArrayGrammarGeneratorFileObjectPart& objects = fileTemplate->GetObjects();
+
+	for( unsigned int i = 0; i < objects.size() ; ++i ) {
+
+		std::string content = objects[i].GetContent();
+		DoReplaceMacros( content );
+
+		if( objects[i].GetFile() == "header" )
+		{
+			if( objects[i].GetPermission() == "private" )
+				res.headerPrivateInfo += content;
+			else if( objects[i].GetPermission() == "protected" )
+				res.headerProtectedInfo += content;
+			else
+				res.headerPublicInfo += content;
+		}
+		else
+			res.srcInfo += content;
+	}
+}
+
 void CXBindingsCppObjectsGenerator::DoGenerateMacroForChildEnumerator( CXBindingsRuleInfo& ruleInfo , CXBindingsArrayGrammarChildInfo& childs , CXBindings& , CXBindingsGeneratorOptions& )
 {
 	/** @todo manage here enumaration for types different from a string */
+	SetMacro( "child_enum_cases" , stdEmptyString ) ;
+
 	if( childs.size() > 0 ) {
 		std::string child_enum_list;
 		std::string child_string_enum_list;
 
+		/* values are found by a switch on their length and first character as
+		 * element names in generated handlers, see GetNameSwitchCase
+		 */
+		std::map< unsigned long , std::string > labels;
+		std::map< unsigned long , std::string > cases;
+
 		for( unsigned int i = 0; i < childs.size() ; ++i ) {
+			std::string value = childs[i].properties[ruleInfo.variable.content];
+
 			if( i == 0 )
-				child_enum_list += "\t$(ns)" + childs[i].properties[ruleInfo.variable.content] + " = 0,\n" ;
+				child_enum_list += "\t$(ns)" + value + " = 0,\n" ;
 			else
-				child_enum_list += "\t$(ns)" + childs[i].properties[ruleInfo.variable.content] + ",\n" ;
+				child_enum_list += "\t$(ns)" + value + ",\n" ;
+
+			unsigned long key = GetNameSwitchKey( value );
+
+			if( labels.find( key ) == labels.end() )
+				labels[key] = GetNameSwitchCase( value );
+
+			labels[key] += " /* " + value + " */";
+			cases[key] += "\t\t\tif( value == $(name)Values[$(ns)" + value + "] )\n" ;
+			cases[key] += "\t\t\t\treturn $(ns)" + value + ";\n" ;
 
 
 			std::string str = GetMacro("string_composer") ;
@@ -759,8 +959,18 @@ void CXBindingsCppObjectsGenerator::DoGenerateMacroForChildEnumerator( CXBinding
 				child_string_enum_list += "\t"   + str;
 		}
 
+		std::string child_enum_cases;
+		std::map< unsigned long , std::string >::iterator it = cases.begin();
+
+		for( ; it != cases.end() ; ++it ) {
+			child_enum_cases += "\t\tcase " + labels[it->first] + " :\n" ;
+			child_enum_cases += it->second;
+			child_enum_cases += "\t\t\tbreak;\n" ;
+		}
+
 		SetMacro( "child_enum_list" , child_enum_list ) ;
 		SetMacro( "child_string_enum_list" , child_string_enum_list ) ;
+		SetMacro( "child_enum_cases" , child_enum_cases ) ;
 	}
 
 }
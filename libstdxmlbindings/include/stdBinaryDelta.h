@@ -0,0 +1,476 @@
+/**
+ * @file stdBinaryDelta.h
+ * @brief main file for encoding the differences between two objects in the compact binary format
+ * @author Nicolas Macherey (nm@graymat.fr)
+ * @version 10.4
+ */
+#ifndef STD_BINARYDELTA_H
+#define STD_BINARYDELTA_H
+
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include <boost/type_traits/is_base_of.hpp>
+
+#include "stdException.h"
+#include "stdObject.h"
+#include "stdObjectHash.h"
+#include "stdBinaryStream.h"
+#include "stdBinarySerializer.h"
+
+/** @name Delta fields
+  * A delta is a sequence of operations on the members of an object, each member
+  * being designated by its field number as written by the binary handlers :
+  *	- SET gives the new value of members in the fields of a nested object,
+  *	  exactly as they are encoded, it is applied by reading them in the object.
+  *	- UNSET gives the field number of a member which is removed.
+  *	- CHANGE modifies an object or array member in place, see the change fields.
+  */
+/*@{*/
+#define stdBINARY_DELTA_SET 1
+#define stdBINARY_DELTA_UNSET 2
+#define stdBINARY_DELTA_CHANGE 3
+/*@}*/
+
+/** @name Change fields
+  * A change starts with the field number of its member followed by its edits.
+  * Edits of arrays apply at the index given by the last INDEX field, 0 if there
+  * is none, the index moves to the next item after an UPDATE :
+  *	- UPDATE is the delta of the object member or of the item at the index.
+  *	- REMOVE gives the number of items removed at the index.
+  *	- INSERT gives items inserted at the index, encoded as the fields of the
+  *	  array member in a nested object.
+  */
+/*@{*/
+#define stdBINARY_CHANGE_MEMBER 1
+#define stdBINARY_CHANGE_INDEX 2
+#define stdBINARY_CHANGE_UPDATE 3
+#define stdBINARY_CHANGE_REMOVE 4
+#define stdBINARY_CHANGE_INSERT 5
+/*@}*/
+
+/** @class stdBinaryArrayDiff
+  * @brief Range of the items which differ between two arrays.
+  *
+  * The items before start and after the ends are equal in both arrays, the
+  * items of the range are compared by pairs for the arrays of objects so that
+  * only their modified members are written, the remaining ones are removed from
+  * or inserted in the array.
+  *
+  * @author Nicolas Macherey (nm@graymat.fr)
+  * @date 8-May-2010
+  */
+struct stdBinaryArrayDiff
+{
+	/** Compare the given arrays */
+	template< class T > stdBinaryArrayDiff( const std::vector< T >& from , const std::vector< T >& to ):
+		start(0),
+		fromEnd(from.size()),
+		toEnd(to.size())
+	{
+		/* shared arrays are equal */
+		if( &from == &to ) {
+			start = fromEnd;
+			return;
+		}
+
+		while( start < fromEnd && start < toEnd && stdHashedEqual( from[start] , to[start] ) )
+			++start;
+
+		while( fromEnd > start && toEnd > start && stdHashedEqual( from[fromEnd - 1] , to[toEnd - 1] ) ) {
+			--fromEnd;
+			--toEnd;
+		}
+	};
+
+	/** Check if the arrays are equal */
+	bool IsEmpty() const {return start == fromEnd && start == toEnd;};
+
+	/** Get the number of items of the range which are in both arrays */
+	unsigned int GetPairs() const {return std::min( fromEnd , toEnd ) - start;};
+
+	/** first item which differs */
+	unsigned int start;
+
+	/** end of the range in the first array */
+	unsigned int fromEnd;
+
+	/** end of the range in the second array */
+	unsigned int toEnd;
+};
+
+/** Get the item of a patched array at the given index, a delta which does not
+  * match the array throws a stdException */
+template< class T > inline T& stdBinaryDeltaAt( std::vector< T >& items , unsigned int index )
+{
+	if( index >= items.size() )
+		STD_THROW( "Error the delta does not match the patched array, index out of bounds" );
+
+	return items[index];
+}
+
+/** Move the items appended to a patched array since it had the given size at the
+  * given index */
+template< class T > inline void stdBinaryDeltaInsert( std::vector< T >& items , unsigned int index , size_t size )
+{
+	if( index > size || size > items.size() )
+		STD_THROW( "Error the delta does not match the patched array, index out of bounds" );
+
+	std::rotate( items.begin() + index , items.begin() + size , items.end() );
+}
+
+/** Remove the given number of items of a patched array at the given index */
+template< class T > inline void stdBinaryDeltaErase( std::vector< T >& items , unsigned int index , unsigned int count )
+{
+	if( index > items.size() || count > items.size() - index )
+		STD_THROW( "Error the delta does not match the patched array, index out of bounds" );
+
+	items.erase( items.begin() + index , items.begin() + index + count );
+}
+
+/** @class stdBinaryDeltaWriter
+  * @brief Writes the delta of an object, this is used by the Diff method of the
+  * generated binary handlers.
+  *
+  * The new values of the members are written in GetValues and gathered in a
+  * single SET operation by Close. Changes and updates which turn out to be empty
+  * are removed from the output, so that the delta of two equal objects is empty.
+  *
+  * @code
+  * stdBinaryDeltaWriter delta( writer );
+  * if( from.GetName() != to.GetName() )
+  *	delta.GetValues().Write( 1 , to.GetName() );
+  * delta.StartChange( 2 );
+  * delta.Remove( 3 , 1 );
+  * delta.EndChange();
+  * delta.Close();
+  * @endcode
+  *
+  * @author Nicolas Macherey (nm@graymat.fr)
+  * @date 8-May-2010
+  */
+class stdBinaryDeltaWriter
+{
+public :
+	/** Constructor
+	  * @param writer writer receiving the delta, nested deltas are written in the
+	  * same writer by their own stdBinaryDeltaWriter
+	  */
+	stdBinaryDeltaWriter( stdBinaryWriter& writer ):
+		m_writer(&writer),
+		m_values(m_sets),
+		m_change(0),
+		m_edit(0),
+		m_kind(0),
+		m_start(0),
+		m_editStart(0),
+		m_index(0),
+		m_previous(0),
+		m_edits(0)
+	{};
+
+	/** Get the writer of the new values of the members, their fields are encoded
+	  * as in the object */
+	stdBinaryWriter& GetValues() {return m_values;};
+
+	/** Remove the member of the given field */
+	void Unset( unsigned int member );
+
+	/** Start the change of the member of the given field */
+	void StartChange( unsigned int member );
+
+	/** Terminate the current change
+	  * @param keep write the change even if it has no edit, this marks the member
+	  * as set
+	  */
+	void EndChange( bool keep = false );
+
+	/** Start an UPDATE or an INSERT edit of the current change
+	  * @param edit stdBINARY_CHANGE_UPDATE or stdBINARY_CHANGE_INSERT
+	  * @param index index of the item in the array as patched so far, 0 for object
+	  * members. Updates shall be written in the order of their items.
+	  * @return the writer of the nested delta or of the inserted items
+	  */
+	stdBinaryWriter& StartEdit( unsigned int edit , unsigned int index = 0 );
+
+	/** Terminate the current edit, it is removed if nothing has been written */
+	void EndEdit();
+
+	/** Remove the given number of items at the given index, nothing is written
+	  * if count is 0 */
+	void Remove( unsigned int index , unsigned int count );
+
+	/** Write the changes of an array of values
+	  * @param member field of the array
+	  * @param from items of the first object
+	  * @param to items of the second object
+	  * @param keep write the change even if the arrays are equal, see EndChange
+	  */
+	template< class T > void DiffValues( unsigned int member , const std::vector< T >& from , const std::vector< T >& to , bool keep )
+	{
+		stdBinaryArrayDiff range( from , to );
+
+		if( range.IsEmpty() && !keep )
+			return;
+
+		StartChange( member );
+		Remove( range.start , range.fromEnd - range.start );
+
+		if( range.toEnd > range.start ) {
+			stdBinaryWriter& items = StartEdit( stdBINARY_CHANGE_INSERT , range.start );
+
+			for( unsigned int i = range.start ; i < range.toEnd ; ++i )
+				items.Write( member , to[i] );
+
+			EndEdit();
+		}
+
+		EndChange( keep );
+	};
+
+	/** Write the changes of an array of objects, the items which are in both arrays
+	  * are updated with the delta of their members. The equal items around the
+	  * range are compared as well since the equality of generated objects does
+	  * not see the members which are only set in one of them.
+	  * @param H binary handler of the items
+	  * @see DiffValues
+	  */
+	template< class H , class T > void DiffObjects( unsigned int member , const std::vector< T >& from , const std::vector< T >& to , bool keep )
+	{
+		StartChange( member );
+
+		/* shared arrays are equal */
+		if( &from != &to ) {
+			stdBinaryArrayDiff range( from , to );
+			unsigned int pairs = range.GetPairs();
+			unsigned int suffix = from.size() - range.fromEnd;
+
+			for( unsigned int i = 0 ; i < range.start + pairs ; ++i ) {
+				H::Diff( StartEdit( stdBINARY_CHANGE_UPDATE , i ) , from[i] , to[i] );
+				EndEdit();
+			}
+
+			for( unsigned int i = 0 ; i < suffix ; ++i ) {
+				H::Diff( StartEdit( stdBINARY_CHANGE_UPDATE , range.fromEnd + i ) , from[range.fromEnd + i] , to[range.toEnd + i] );
+				EndEdit();
+			}
+
+			Remove( range.start + pairs , range.fromEnd - range.start - pairs );
+
+			if( range.toEnd > range.start + pairs ) {
+				stdBinaryWriter& items = StartEdit( stdBINARY_CHANGE_INSERT , range.start + pairs );
+
+				for( unsigned int i = range.start + pairs ; i < range.toEnd ; ++i ) {
+					size_t mark = items.StartMessage( member );
+					H::Write( items , to[i] );
+					items.EndMessage( mark );
+				}
+
+				EndEdit();
+			}
+		}
+
+		EndChange( keep );
+	};
+
+	/** Write the changes of an array of objects whose class is only known at run
+	  * time, the items are compared by their encoding.
+	  * @see DiffValues
+	  */
+	template< class T > void DiffAny( unsigned int member , const std::vector< T* >& from , const std::vector< T* >& to , bool keep )
+	{
+		stdBinarySerializer* serializer = stdBinarySerializer::Get();
+		unsigned int start = 0;
+		unsigned int fromEnd = from.size();
+		unsigned int toEnd = to.size();
+
+		while( start < fromEnd && start < toEnd && serializer->Equals( from[start] , to[start] ) )
+			++start;
+
+		while( fromEnd > start && toEnd > start && serializer->Equals( from[fromEnd - 1] , to[toEnd - 1] ) ) {
+			--fromEnd;
+			--toEnd;
+		}
+
+		if( start == fromEnd && start == toEnd && !keep )
+			return;
+
+		StartChange( member );
+		Remove( start , fromEnd - start );
+
+		if( toEnd > start ) {
+			stdBinaryWriter& items = StartEdit( stdBINARY_CHANGE_INSERT , start );
+
+			for( unsigned int i = start ; i < toEnd ; ++i )
+				if( to[i] != NULL )
+					serializer->WriteObject( items , member , to[i] );
+
+			EndEdit();
+		}
+
+		EndChange( keep );
+	};
+
+	/** Write the new values of the members, this shall be called once all the
+	  * members have been compared */
+	void Close();
+
+private :
+	/** Write the index of the next edit if it is not the current one */
+	void DoWriteIndex( unsigned int index );
+
+	/** writer of the delta */
+	stdBinaryWriter* m_writer;
+
+	/** fields of the new values */
+	std::string m_sets;
+
+	/** writer of m_sets */
+	stdBinaryWriter m_values;
+
+	/** mark of the current change */
+	size_t m_change;
+
+	/** mark of the current edit */
+	size_t m_edit;
+
+	/** current edit, stdBINARY_CHANGE_UPDATE or stdBINARY_CHANGE_INSERT */
+	unsigned int m_kind;
+
+	/** offset of the current change in the output */
+	size_t m_start;
+
+	/** offset of the current edit in the output, including its index */
+	size_t m_editStart;
+
+	/** index of the next edit of the current change */
+	unsigned int m_index;
+
+	/** index before the current edit */
+	unsigned int m_previous;
+
+	/** number of edits written in the current change */
+	unsigned int m_edits;
+};
+
+/** @class stdBinaryDeltaChange
+  * @brief Reads an UNSET or a CHANGE operation of a delta, this is used by the
+  * Patch method of the generated binary handlers.
+  *
+  * @author Nicolas Macherey (nm@graymat.fr)
+  * @date 8-May-2010
+  */
+class stdBinaryDeltaChange
+{
+public :
+	/** Default constructor */
+	stdBinaryDeltaChange():
+		m_member(0),
+		m_unset(false),
+		m_edit(0),
+		m_index(0),
+		m_next(0),
+		m_count(0)
+	{};
+
+	/** Read the operation of the current field of the given delta
+	  * @return false if the operation has been skipped because of its wire type
+	  */
+	bool Read( stdBinaryReader& delta );
+
+	/** Get the field number of the member */
+	unsigned int GetMember() const {return m_member;};
+
+	/** Check if the member is removed */
+	bool IsUnset() const {return m_unset;};
+
+	/** Move to the next edit of the change
+	  * @return false if there are no more edits
+	  */
+	bool Next();
+
+	/** Get the current edit, stdBINARY_CHANGE_UPDATE, stdBINARY_CHANGE_REMOVE or
+	  * stdBINARY_CHANGE_INSERT */
+	unsigned int GetEdit() const {return m_edit;};
+
+	/** Get the index the current edit applies at */
+	unsigned int GetIndex() const {return m_index;};
+
+	/** Get the number of items removed by a REMOVE edit */
+	unsigned int GetCount() const {return m_count;};
+
+	/** Get the reader of the nested delta of an UPDATE edit or of the items of
+	  * an INSERT edit */
+	stdBinaryReader& GetValue() {return m_value;};
+
+	/** Apply the edits of an array of values
+	  * @param H binary handler of the object, the inserted items are read by H::Read
+	  * which appends them to the array
+	  * @param object object owning the array
+	  * @param items array
+	  */
+	template< class H , class C , class T > void PatchValues( C& object , std::vector< T >& items )
+	{
+		PatchObjects< H , H >( object , items );
+	};
+
+	/** Apply the edits of an array of objects
+	  * @param H binary handler of the object, see PatchValues
+	  * @param I binary handler of the items, updated items are patched by I::Patch
+	  */
+	template< class H , class I , class C , class T > void PatchObjects( C& object , std::vector< T >& items )
+	{
+		while( Next() ) {
+			switch( m_edit )
+			{
+			case stdBINARY_CHANGE_UPDATE :
+				DoPatch< I >( stdBinaryDeltaAt( items , m_index ) , boost::is_base_of< stdObject , T >() );
+				break;
+			case stdBINARY_CHANGE_INSERT :
+			{
+				size_t size = items.size();
+				H::Read( m_value , object );
+				stdBinaryDeltaInsert( items , m_index , size );
+				break;
+			}
+			case stdBINARY_CHANGE_REMOVE :
+				stdBinaryDeltaErase( items , m_index , m_count );
+				break;
+			}
+		}
+	};
+
+private :
+	/** Patch an updated item */
+	template< class I , class T > void DoPatch( T& item , boost::true_type ) {I::Patch( m_value , item );};
+
+	/** Values are never updated, they are removed and inserted */
+	template< class I , class T > void DoPatch( T& , boost::false_type ) {};
+
+	/** reader of the edits */
+	stdBinaryReader m_edits;
+
+	/** reader of the current edit value */
+	stdBinaryReader m_value;
+
+	/** field of the member */
+	unsigned int m_member;
+
+	/** true for an UNSET operation */
+	bool m_unset;
+
+	/** current edit */
+	unsigned int m_edit;
+
+	/** index of the current edit */
+	unsigned int m_index;
+
+	/** index of the next edit */
+	unsigned int m_next;
+
+	/** number of removed items */
+	unsigned int m_count;
+};
+
+#endif
@@ -0,0 +1,219 @@
+/**
+ * @file stdBinarySerializer.h
+ * @brief main file for serializing objects in the compact binary format
+ * @author Nicolas Macherey (nm@graymat.fr)
+ * @version 10.4
+ */
+#ifndef STD_BINARYSERIALIZER_H
+#define STD_BINARYSERIALIZER_H
+
+#include <string>
+#include <map>
+
+#include <boost/thread/mutex.hpp>
+
+#include "stdSingleton.h"
+#include "stdException.h"
+#include "stdObject.h"
+#include "stdBinaryStream.h"
+
+/** @name Envelope fields
+  * Objects whose class is only known at run time are written in an envelope
+  * giving their class name followed by their fields. Documents are written as
+  * envelopes too, deltas written by stdBinarySerializer::Diff give the class
+  * name of their objects followed by the delta.
+  */
+/*@{*/
+#define stdBINARY_ENVELOPE_CLASS 1
+#define stdBINARY_ENVELOPE_OBJECT 2
+#define stdBINARY_ENVELOPE_DELTA 3
+/*@}*/
+
+/**
+  * @class stdBinaryHandler
+  * @brief Abstract class for encoding and decoding the objects of a class in the
+  * compact binary format.
+  *
+  * Handlers are generated by the CPPBinary generator, they have no state and are
+  * shared by all threads.
+  *
+  * @author Nicolas Macherey (nm@graymat.fr)
+  * @date 8-May-2010
+  */
+class stdBinaryHandler
+{
+public :
+	/** Destructor */
+	virtual ~stdBinaryHandler()
+	{};
+
+	/** Create a new object of the handled class */
+	virtual stdObject* Create() = 0;
+
+	/** Write the fields of the given object */
+	virtual void Encode( stdObject* resource , stdBinaryWriter& writer ) = 0;
+
+	/** Read the fields of the given object */
+	virtual void Decode( stdBinaryReader& reader , stdObject* resource ) = 0;
+
+	/** Write the delta turning from into to, see stdBinaryDelta.h */
+	virtual void Diff( const stdObject* from , const stdObject* to , stdBinaryWriter& writer ) = 0;
+
+	/** Apply a delta written by Diff to the given object */
+	virtual void Patch( stdBinaryReader& reader , stdObject* resource ) = 0;
+};
+
+/** @class stdBinarySerializer
+  * @brief Registry of the stdBinaryHandler's and entry point for serializing
+  * documents in the compact binary format.
+  *
+  * The compact binary format is the binary counterpart of the xml documents
+  * read and written by the stdXmlReader : each member of an object is a field
+  * numbered by the generator, unknown fields are skipped so that data written
+  * by an older or newer version of the schema can still be read.
+  *
+  * @code
+  * std::string data = stdBinarySerializer::Get()->Serialize( resource );
+  * stdObject* copy = stdBinarySerializer::Get()->Load( data );
+  * @endcode
+  *
+  * Objects replicated after each change do not need to be serialized again :
+  * the delta between two versions of an object only gives their modified
+  * members and the items inserted in or removed from their arrays.
+  *
+  * @code
+  * std::string delta = stdBinarySerializer::Get()->Diff( previous , current );
+  * stdBinarySerializer::Get()->Patch( replica , delta );
+  * @endcode
+  *
+  * @author Nicolas Macherey (nm@graymat.fr)
+  * @date 8-May-2010
+  */
+class stdBinarySerializer : public stdSingleton<stdBinarySerializer>
+{
+	friend class stdSingleton<stdBinarySerializer>;
+
+public :
+	/** Register a handler for the given class, the serializer owns it.
+	  * @return false if a handler is already registered for this class, the
+	  * given handler is then deleted
+	  */
+	bool RegisterHandler( const std::string& className , stdBinaryHandler* handler );
+
+	/** Unregister and delete the handler of the given class */
+	bool UnregisterHandler( const std::string& className );
+
+	/** Find the handler of the given class, NULL if there is none */
+	stdBinaryHandler* FindHandler( const std::string& className );
+
+	/** Find the handler of the class of the given resource, NULL if there is none */
+	stdBinaryHandler* FindHandler( stdObject* resource );
+
+	/** Serialize the given resource as a document */
+	std::string Serialize( stdObject* resource );
+
+	/** Serialize the given resource as a document at the end of output */
+	void Serialize( stdObject* resource , std::string& output );
+
+	/** Load a document written by Serialize
+	  * @return the root object of the document
+	  */
+	stdObject* Load( const std::string& data );
+
+	/** Load a document written by Serialize from the given buffer */
+	stdObject* Load( const char* data , size_t size );
+
+	/** Write the given resource in an envelope as the given field, used for
+	  * members whose class is only known at run time.
+	  */
+	void WriteObject( stdBinaryWriter& writer , unsigned int field , stdObject* resource );
+
+	/** Read an envelope written by WriteObject
+	  * @param reader reader of the envelope fields
+	  * @return the object read, NULL if the envelope gives no class name
+	  */
+	stdObject* ReadObject( stdBinaryReader& reader );
+
+	/** Write the delta turning from into to, both objects shall be of the same class
+	  * @return the delta, empty if the objects are equal
+	  */
+	std::string Diff( const stdObject& from , const stdObject& to );
+
+	/** Write the delta turning from into to at the end of output, nothing is
+	  * written if the objects are equal */
+	void Diff( const stdObject& from , const stdObject& to , std::string& output );
+
+	/** Apply a delta written by Diff to the given object, it shall be of the class
+	  * of the objects given to Diff. Applying a delta to an object which is not
+	  * equal to the first of them throws a stdException or gives an undefined
+	  * value.
+	  */
+	void Patch( stdObject& resource , const std::string& delta );
+
+	/** Apply a delta written by Diff from the given buffer */
+	void Patch( stdObject& resource , const char* data , size_t size );
+
+	/** Compare the given objects by their encoding, used for comparing the members
+	  * whose class is only known at run time.
+	  */
+	bool Equals( const stdObject* lhs , const stdObject* rhs );
+
+private :
+	/** Default constructor, use stdBinarySerializer::Get() */
+	stdBinarySerializer()
+	{};
+
+	/** Destructor, deletes the registered handlers */
+	~stdBinarySerializer();
+
+	/** Write the envelope fields of the given resource */
+	void DoWriteEnvelope( stdBinaryWriter& writer , stdObject* resource );
+
+	/** Find the handler of the given class, throws if there is none */
+	stdBinaryHandler* DoGetHandler( const std::string& className );
+
+	/** registered handlers by class name */
+	std::map< std::string , stdBinaryHandler* > m_handlers;
+
+	/** mutex protecting the registry */
+	boost::mutex m_mutex;
+};
+
+/**
+  * @class stdBinaryHandlerRegistrant
+  * @brief Registers a stdBinaryHandler in the stdBinarySerializer for the
+  * lifetime of the registrant.
+  *
+  * @code
+  * stdREGISTER_BINARYHANDLER_FOR( MyBinaryHandler , "MyClass" );
+  * @endcode
+  *
+  * @author Nicolas Macherey (nm@graymat.fr)
+  * @date 8-May-2010
+  */
+template<class T> class stdBinaryHandlerRegistrant
+{
+public :
+	stdBinaryHandlerRegistrant( const std::string& className ):
+		m_className(className)
+	{
+		stdBinarySerializer::Get()->RegisterHandler( className , new T( ) );
+	}
+
+	~stdBinaryHandlerRegistrant()
+	{
+		/* if the serializer is down the handler has already been deleted */
+		if(!stdBinarySerializer::IsDown())
+			stdBinarySerializer::Get()->UnregisterHandler( m_className );
+	};
+
+private :
+	std::string m_className;
+};
+
+#define stdREGISTER_BINARYHANDLER_FOR( object , className ) \
+	namespace ns##object { \
+		stdBinaryHandlerRegistrant<object> registrant( className ); \
+	};
+
+#endif
@@ -0,0 +1,217 @@
+/**
+ * @file stdBinaryStream.h
+ * @brief main file for encoding and decoding objects in the compact binary format
+ * @author Nicolas Macherey (nm@graymat.fr)
+ * @version 10.4
+ */
+#ifndef STD_BINARYSTREAM_H
+#define STD_BINARYSTREAM_H
+
+#include <string>
+
+#include <boost/cstdint.hpp>
+
+/** @name Binary wire types
+  * An encoded object is a sequence of fields, each field starts with a varint
+  * key made of its number and of its wire type : ( field << 3 ) | type.
+  * The key is followed by the value whose encoding depends on the wire type.
+  * This is the same layout as protocol buffers.
+  */
+/*@{*/
+/** unsigned integers and booleans are written as varints, signed integers
+  * are zigzag encoded first so that small negative values stay small.
+  */
+#define stdBINARY_VARINT 0
+/** doubles, 8 bytes little endian */
+#define stdBINARY_FIXED64 1
+/** strings and nested objects, a varint length followed by the content */
+#define stdBINARY_LENGTH 2
+/** floats, 4 bytes little endian */
+#define stdBINARY_FIXED32 5
+/*@}*/
+
+/** @class stdBinaryWriter
+  * @brief Writes fields in the compact binary format at the end of a string.
+  *
+  * Nested objects are written between StartMessage and EndMessage, their length
+  * is written once they are complete so that no temporary buffer is needed.
+  *
+  * @code
+  * std::string data;
+  * stdBinaryWriter writer( data );
+  * writer.Write( 1 , std::string( "Toto" ) );
+  * size_t mark = writer.StartMessage( 2 );
+  * writer.Write( 1 , 24 );
+  * writer.EndMessage( mark );
+  * @endcode
+  *
+  * @author Nicolas Macherey (nm@graymat.fr)
+  * @date 8-May-2010
+  */
+class stdBinaryWriter
+{
+public :
+	/** Constructor
+	  * @param output string receiving the fields, it shall outlive the writer
+	  */
+	stdBinaryWriter( std::string& output ):
+		m_out(&output)
+	{};
+
+	/** @name Fields writing
+	  * Write the given field, see the binary wire types for their encoding
+	  */
+	/*@{*/
+	void Write( unsigned int field , int value );
+	void Write( unsigned int field , unsigned int value );
+	void Write( unsigned int field , long value );
+	void Write( unsigned int field , unsigned long value );
+	void Write( unsigned int field , bool value );
+	void Write( unsigned int field , double value );
+	void Write( unsigned int field , float value );
+	void Write( unsigned int field , const std::string& value );
+	/*@}*/
+
+	/** Start a nested object
+	  * @param field field of the object
+	  * @return the mark to give to EndMessage once the object has been written
+	  */
+	size_t StartMessage( unsigned int field );
+
+	/** Terminate the nested object started at the given mark */
+	void EndMessage( size_t mark );
+
+	/** Get the output string */
+	std::string& GetOutput() {return *m_out;};
+
+private :
+	/** Write a field key */
+	void DoWriteKey( unsigned int field , unsigned int type ) {DoWriteVarint( ( (unsigned long) field << 3 ) | type );};
+
+	/** Write a varint */
+	void DoWriteVarint( unsigned long value );
+
+	/** Write the given number of bytes of value in little endian order */
+	void DoWriteFixed( boost::uint64_t value , int bytes );
+
+	/** output string */
+	std::string* m_out;
+};
+
+/** @class stdBinaryReader
+  * @brief Reads the fields of an object in the compact binary format.
+  *
+  * The reader works directly on the given buffer which shall outlive it. Fields
+  * are read one at a time with Next, their value shall then be read with one of
+  * the Read methods or skipped. Reading a field with a type which does not match
+  * its wire type skips it, so that a field whose type changed is ignored.
+  * Truncated or malformed data throws a stdException.
+  *
+  * @code
+  * stdBinaryReader reader( data );
+  * while( reader.Next() ) {
+  *	switch( reader.GetField() ) {
+  *	case 1 : reader.Read( name ); break;
+  *	default : reader.Skip(); break;
+  *	}
+  * }
+  * @endcode
+  *
+  * @author Nicolas Macherey (nm@graymat.fr)
+  * @date 8-May-2010
+  */
+class stdBinaryReader
+{
+public :
+	/** Default constructor, the reader has no field */
+	stdBinaryReader():
+		m_data(NULL),
+		m_end(NULL),
+		m_field(0),
+		m_type(0)
+	{};
+
+	/** Constructor
+	  * @param data buffer to read
+	  * @param size size of the buffer
+	  */
+	stdBinaryReader( const char* data , size_t size ):
+		m_data((const unsigned char*) data),
+		m_end((const unsigned char*) data + size),
+		m_field(0),
+		m_type(0)
+	{};
+
+	/** Constructor, the string shall outlive the reader */
+	explicit stdBinaryReader( const std::string& data ):
+		m_data((const unsigned char*) data.data()),
+		m_end((const unsigned char*) data.data() + data.size()),
+		m_field(0),
+		m_type(0)
+	{};
+
+	/** Move to the next field
+	  * @return false if there are no more fields
+	  */
+	bool Next();
+
+	/** Get the number of the current field */
+	unsigned int GetField() const {return m_field;};
+
+	/** Get the wire type of the current field */
+	unsigned int GetWireType() const {return m_type;};
+
+	/** @name Fields reading
+	  * Read the value of the current field
+	  * @param value [out] read value, unchanged if the wire type does not match
+	  * @return false if the value has been skipped because of its wire type
+	  */
+	/*@{*/
+	bool Read( int& value );
+	bool Read( unsigned int& value );
+	bool Read( long& value );
+	bool Read( unsigned long& value );
+	bool Read( bool& value );
+	bool Read( double& value );
+	bool Read( float& value );
+	bool Read( std::string& value );
+	/*@}*/
+
+	/** Read the current field as a nested object
+	  * @param message [out] reader of the nested object fields
+	  * @return false if the value has been skipped because of its wire type
+	  */
+	bool ReadMessage( stdBinaryReader& message );
+
+	/** Skip the value of the current field */
+	void Skip();
+
+private :
+	/** Check the wire type of the current field and skip its value if it does
+	  * not match the given one.
+	  */
+	bool DoCheckType( unsigned int type );
+
+	/** Read a varint */
+	unsigned long DoReadVarint();
+
+	/** Read the given number of bytes as a little endian value */
+	boost::uint64_t DoReadFixed( int bytes );
+
+	/** Read the length of a length delimited value and check it */
+	size_t DoReadLength();
+
+	/** current position */
+	const unsigned char* m_data;
+
+	/** end of the buffer */
+	const unsigned char* m_end;
+
+	/** current field number */
+	unsigned int m_field;
+
+	/** current field wire type */
+	unsigned int m_type;
+};
+
+#endif
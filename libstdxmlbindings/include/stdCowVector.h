@@ -0,0 +1,165 @@
+/**
+ * @file stdCowVector.h
+ * @brief main file for sharing the arrays of generated objects between their copies
+ * @author Nicolas Macherey (nm@graymat.fr)
+ * @version 10.4
+ */
+#ifndef STD_COWVECTOR_H
+#define STD_COWVECTOR_H
+
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
+#include "stdDefines.h"
+
+/** @class stdCowVector
+  * @brief Array shared between the copies of an object until one of them modifies it.
+  *
+  * Generated objects hold their arrays in stdCowVector when they are generated with
+  * the --shared-arrays option, so that copying or cloning an object does not copy
+  * its arrays : the copies share the items of the arrays, and an array is copied
+  * only when one of the objects sharing it modifies it. Since the items of arrays
+  * of objects share their own arrays, copies of large object graphs only copy the
+  * parts which are modified.
+  *
+  * Read gives the shared items, Write gives items owned by this array only. As for
+  * any implicitly shared container, a reference obtained from Write shall not be
+  * used to modify the array after its object has been copied, the copy would see
+  * the modification. The accessors of generated objects keep their std::vector
+  * types, their const accessors never copy the arrays.
+  *
+  * The items are shared using a thread safe reference count, objects sharing an
+  * array can be modified by different threads.
+  *
+  * @author Nicolas Macherey (nm@graymat.fr)
+  * @date 8-May-2010
+  */
+template< class T > class stdCowVector
+{
+public :
+	/** type of the shared items */
+	typedef std::vector< T > vector_type;
+
+	/** Default constructor, the array is empty and does not allocate */
+	stdCowVector() {};
+
+	/** Constructor, copies the given items */
+	stdCowVector( const vector_type& items ):
+		m_items( items.empty() ? NULL : new vector_type( items ) )
+	{};
+
+	/** Copy constructor, the items of rhs are shared */
+	stdCowVector( const stdCowVector& rhs ):
+		m_items( rhs.m_items )
+	{};
+
+	/** operator= overload, the items of rhs are shared */
+	stdCowVector& operator=( const stdCowVector& rhs )
+	{
+		m_items = rhs.m_items;
+		return (*this);
+	};
+
+	/** operator= overload, copies the given items */
+	stdCowVector& operator=( const vector_type& items )
+	{
+		if( m_items && m_items.use_count() == 1 )
+			*m_items = items;
+		else
+			m_items.reset( new vector_type( items ) );
+
+		return (*this);
+	};
+
+#ifdef stdHAS_RVALUE_REFERENCES
+	/** Constructor, moves the given items */
+	stdCowVector( vector_type&& items ):
+		m_items( new vector_type( std::move( items ) ) )
+	{};
+
+	/** Move constructor, the items are taken from rhs */
+	stdCowVector( stdCowVector&& rhs ) noexcept
+	{
+		m_items.swap( rhs.m_items );
+	};
+
+	/** Move assignment, the items are taken from rhs */
+	stdCowVector& operator=( stdCowVector&& rhs ) noexcept
+	{
+		if( this != &rhs ) {
+			m_items.reset();
+			m_items.swap( rhs.m_items );
+		}
+
+		return (*this);
+	};
+
+	/** operator= overload, moves the given items */
+	stdCowVector& operator=( vector_type&& items )
+	{
+		if( m_items && m_items.use_count() == 1 )
+			*m_items = std::move( items );
+		else
+			m_items.reset( new vector_type( std::move( items ) ) );
+
+		return (*this);
+	};
+#endif
+
+	/** Get the items, they may be shared with other arrays */
+	const vector_type& Read() const
+	{
+		if( !m_items )
+			return Empty();
+
+		return *m_items;
+	};
+
+	/** Get the items for modifying them, they are copied first if they are shared
+	  * with other arrays
+	  */
+	vector_type& Write()
+	{
+		if( !m_items )
+			m_items.reset( new vector_type );
+		else if( m_items.use_count() != 1 )
+			m_items.reset( new vector_type( *m_items ) );
+
+		return *m_items;
+	};
+
+	/** Remove all the items, the storage is kept if it is not shared */
+	void clear()
+	{
+		if( m_items && m_items.use_count() == 1 )
+			m_items->clear();
+		else
+			m_items.reset();
+	};
+
+	/** Check if the items are shared with other arrays */
+	bool IsShared() const {return m_items && m_items.use_count() != 1;};
+
+	/** operator== overload, arrays sharing their items are equal without comparing them */
+	bool operator==( const stdCowVector& rhs ) const
+	{
+		return m_items == rhs.m_items || Read() == rhs.Read();
+	};
+
+	/** operator!= overload */
+	bool operator!=( const stdCowVector& rhs ) const {return !( (*this) == rhs );};
+
+private :
+	/** items of the arrays which are never set */
+	static const vector_type& Empty()
+	{
+		static const vector_type empty;
+		return empty;
+	};
+
+	/** items, NULL while the array has never been set */
+	boost::shared_ptr< vector_type > m_items;
+};
+
+#endif
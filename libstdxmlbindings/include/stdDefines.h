@@ -8,7 +8,11 @@
 #define STD_DEFINES_H
 
 #include <string>
+#include <cstring>
 #include <set>
+#include <vector>
+
+#include "stdNumeric.h"
 
 const std::string stdEmptyString = "";
 #define stdNOT_FOUND -1
@@ -16,6 +20,63 @@ const std::string stdEmptyString = "";
 #define stdx2C( str ) reinterpret_cast<const xmlChar*>( str.c_str() )
 #define stdc2C( str ) str.c_str()
 
+/** Defined when the compiler supports rvalue references and noexcept, generated
+  * objects then have move constructors and move assignment operators.
+  */
+#if __cplusplus >= 201103L || ( defined(_MSC_VER) && _MSC_VER >= 1900 )
+#define stdHAS_RVALUE_REFERENCES
+#endif
+
+/** Defined when the standard library provides std::hash, generated objects then
+  * specialize it so that they can be used in std::unordered containers.
+  */
+#if __cplusplus >= 201103L || ( defined(_MSC_VER) && _MSC_VER >= 1900 )
+#define stdHAS_STD_HASH
+#include <functional>
+#endif
+
+#ifdef stdHAS_RVALUE_REFERENCES
+#include <utility>
+#define stdMOVE( value ) std::move( value )
+#else
+#define stdMOVE( value ) ( value )
+#endif
+
+/** Type of the parameters taken by generated setters : values are taken by value
+  * and moved to the members when the compiler supports it, by const reference
+  * otherwise.
+  */
+template< class T > struct stdSink
+{
+#ifdef stdHAS_RVALUE_REFERENCES
+	typedef T type;
+#else
+	typedef const T& type;
+#endif
+};
+
+/** Build the key used by generated handlers to dispatch on element names in a switch.
+  * Names are dispatched on their length and first character, the matching case then
+  * compares the whole name.
+  */
+#define stdXML_NAME_KEY( length , first ) ( ( (unsigned long) (length) << 8 ) | (unsigned char) (first) )
+
+/** Get the dispatch key of the given name, see stdXML_NAME_KEY */
+inline unsigned long stdXmlNameKey( const char* name )
+{
+	if( *name == 0 )
+		return 0;
+
+	return stdXML_NAME_KEY( strlen( name ) , name[0] );
+}
+
+/** Hash function used for indexing handlers by interned names */
+inline long stdXmlHashPointer( const void* ptr )
+{
+	unsigned long hash = (unsigned long) ( (size_t) ptr >> 3 ) * 2654435761UL;
+	return (long) (hash & 0x7FFFFFFFUL);
+}
+
 /** Get the attribute content in the given node
   * @param node node to get the named attribute in
   * @param name attribute name to get
@@ -34,6 +95,120 @@ inline std::string GetXmlAttr( xmlNode* node , const std::string& name )
 	return ret;
 }
 
+/** @class stdXmlAttrValue
+  * @brief View on the value of an xml attribute.
+  *
+  * The value of an attribute is most of the time a single text node, in that case
+  * the stdXmlAttrValue points directly to the libxml2 content and nothing is copied
+  * until the value is assigned. Values made of several nodes (entity references) are
+  * concatenated in a buffer owned by the view.
+  */
+class stdXmlAttrValue
+{
+public :
+	/** Constructor
+	  * @param attr attribute to get the value of, it shall outlive the view
+	  */
+	stdXmlAttrValue( xmlAttr* attr ):
+		m_value(""),
+		m_buffer(NULL)
+	{
+		xmlNode* text = attr->children;
+
+		if( text == NULL )
+			return;
+
+		if( text->next == NULL && text->type == XML_TEXT_NODE ) {
+			if( text->content != NULL )
+				m_value = (const char*) text->content;
+		}
+		else {
+			m_buffer = xmlNodeListGetString( attr->doc , text , 1 );
+
+			if( m_buffer != NULL )
+				m_value = (const char*) m_buffer;
+		}
+	};
+
+	/** Destructor, frees the value buffer if any */
+	~stdXmlAttrValue()
+	{
+		if( m_buffer != NULL )
+			xmlFree( m_buffer );
+	};
+
+	/** Get the zero terminated value */
+	const char* c_str() const {return m_value;};
+
+	/** Check if the value is empty */
+	bool empty() const {return *m_value == 0;};
+
+	/** Compare the value with the given string, same as strcmp */
+	int compare( const char* str ) const {return strcmp( m_value , str );};
+
+	/** Copy the value in a std::string */
+	std::string str() const {return m_value;};
+
+	/** Parse the value as a number, see stdParseNumber */
+	template< class T > bool ToNumber( T& value ) const {return stdParseNumber( m_value , value );};
+
+private :
+	/** views cannot be copied */
+	stdXmlAttrValue( const stdXmlAttrValue& );
+	stdXmlAttrValue& operator=( const stdXmlAttrValue& );
+
+	/** value */
+	const char* m_value;
+
+	/** buffer owning the value when it has been concatenated */
+	xmlChar* m_buffer;
+};
+
+/** Count the elements having the same name as the given one among the given
+  * element and its following siblings.
+  * Handlers use it to reserve their arrays before reading their items.
+  */
+inline unsigned int stdXmlCountSiblings( xmlNode* node )
+{
+	unsigned int count = 0;
+
+	for( xmlNode* sibling = node ; sibling != NULL ; sibling = sibling->next )
+		if( sibling->type == XML_ELEMENT_NODE && xmlStrEqual( sibling->name , node->name ) )
+			++count;
+
+	return count;
+}
+
+/** Readers cannot look ahead, only the current element is counted */
+inline unsigned int stdXmlCountSiblings( xmlTextReaderPtr )
+{
+	return 1;
+}
+
+/** Remove the items which could not be created after converting a run of elements
+  * @param items array whose items have been created from the index base
+  * @param base index of the first created item
+  * @param results result of the creation of each item, NULL if it failed
+  * @return true if at least one item has been created
+  */
+template< class T , class P > inline bool stdXmlKeepCreated( std::vector< T >& items , size_t base , const std::vector< P >& results )
+{
+	size_t count = base;
+
+	for( size_t i = 0; i < results.size() ; ++i ) {
+		if( results[i] == NULL )
+			continue;
+
+		if( count != base + i )
+			items[count] = items[base + i];
+
+		++count;
+	}
+
+	items.erase( items.begin() + count , items.end() );
+	return count > base;
+}
+
 /** Get the content of the node as a std::string 
   * @param node node to get the content for
   */
@@ -49,6 +224,72 @@ inline std::string GetXmlContent( xmlNode* node )
 
 	return ret;
 }
+
+/** Get the content of the element the reader is positioned on as a std::string.
+  * The text, CDATA and whitespace nodes of the element are concatenated like
+  * xmlNodeGetContent does and the reader is left on the element's end tag (or
+  * on the element itself if it is empty), so that xmlTextReaderNext moves to
+  * its next sibling.
+  * @param reader reader positioned on the element to get the content for
+  */
+inline std::string GetXmlContent( xmlTextReaderPtr reader )
+{
+	std::string ret;
+
+	if( xmlTextReaderIsEmptyElement( reader ) )
+		return ret;
+
+	int depth = xmlTextReaderDepth( reader );
+
+	while( xmlTextReaderRead( reader ) == 1 ) {
+		int type = xmlTextReaderNodeType( reader );
+
+		if( type == XML_READER_TYPE_END_ELEMENT && xmlTextReaderDepth( reader ) == depth )
+			break;
+
+		if( type == XML_READER_TYPE_TEXT || type == XML_READER_TYPE_CDATA ||
+			type == XML_READER_TYPE_WHITESPACE || type == XML_READER_TYPE_SIGNIFICANT_WHITESPACE ) {
+			const xmlChar* value = xmlTextReaderConstValue( reader );
+
+			if( value != NULL )
+				ret += (const char*) value;
+		}
+	}
+
+	return ret;
+}
 	
-#endif		
-		
\ No newline at end of file
+/** Read the given node content as a number.
+  * The content of simple elements is a single text node which is parsed in place
+  * without any copy, see stdParseNumber.
+  * @param node node to read the content of
+  * @param value [out] read value, left unchanged if the node does not contain a number
+  * @return false if the content is not a number
+  */
+template< class T > inline bool GetXmlNumber( xmlNode* node , T& value )
+{
+	xmlNode* text = node->children;
+
+	if( text == NULL )
+		return false;
+
+	if( text->next == NULL && ( text->type == XML_TEXT_NODE || text->type == XML_CDATA_SECTION_NODE ) )
+		return stdParseNumber( (const char*) text->content , value );
+
+	xmlChar* content = xmlNodeGetContent( node );
+	bool ret = content != NULL && stdParseNumber( (const char*) content , value );
+	xmlFree( content );
+
+	return ret;
+}
+
+/** Read the content of the element the reader is positioned on as a number, the
+  * reader is moved like GetXmlContent does. 
+  * Numbers fit in the std::string small buffer so this does not allocate either.
+  */
+template< class T > inline bool GetXmlNumber( xmlTextReaderPtr reader , T& value )
+{
+	return stdParseNumber( GetXmlContent( reader ).c_str() , value );
+}
+
+#endif
@@ -0,0 +1,52 @@
+/**
+ * @file stdNumeric.h
+ * @brief numeric values parsing and formatting for reading and writing xml files
+ * @author Nicolas Macherey (nm@graymat.fr)
+ * @version 10.4
+ */
+#ifndef STD_NUMERIC_H
+#define STD_NUMERIC_H
+
+/** Size of the buffers given to stdFormatNumber, any value fits in it
+  * including the terminal zero.
+  */
+#define stdNUMERIC_BUFFER_SIZE 32
+
+/** @name Numeric parsing
+  * Parse the number at the begining of the given string.
+  * These functions work directly on the given buffer, they never allocate and do not
+  * depend on the current locale. Leading xml whitespaces and a leading '+' are skipped
+  * and the parsing stops at the first character which cannot be part of the number,
+  * like a stream extraction would do. Out of range integers are clamped.
+  * @param str zero terminated string to parse
+  * @param value [out] parsed value, left unchanged if no number can be read
+  * @return false if no number can be read from str
+  */
+/*@{*/
+bool stdParseNumber( const char* str , int& value );
+bool stdParseNumber( const char* str , unsigned int& value );
+bool stdParseNumber( const char* str , long& value );
+bool stdParseNumber( const char* str , unsigned long& value );
+bool stdParseNumber( const char* str , double& value );
+bool stdParseNumber( const char* str , float& value );
+/*@}*/
+
+/** @name Numeric formatting
+  * Write the given number in the given buffer which shall be at least
+  * stdNUMERIC_BUFFER_SIZE long.
+  * Floating point values are written with the shortest representation which reads
+  * back to the same value.
+  * @param buffer [out] buffer receiving the zero terminated number
+  * @param value value to write
+  * @return the number of characters written, the terminal zero excluded
+  */
+/*@{*/
+int stdFormatNumber( char* buffer , int value );
+int stdFormatNumber( char* buffer , unsigned int value );
+int stdFormatNumber( char* buffer , long value );
+int stdFormatNumber( char* buffer , unsigned long value );
+int stdFormatNumber( char* buffer , double value );
+int stdFormatNumber( char* buffer , float value );
+/*@}*/
+
+#endif
@@ -324,6 +324,9 @@ protected:
 /*!
 @class stdObjectRefData
 @brief ref counted data meant to be stored in stdObject
+When the library is built with STDXMLBINDINGS_ATOMIC_REFCOUNT (the default), the
+reference count is updated atomically so that objects sharing their data can be
+copied and destroyed from several threads at once.
 */
 
 class stdObjectRefData {
@@ -333,11 +336,15 @@ public:
 	stdObjectRefData() : m_count(1) { }
 	virtual ~stdObjectRefData() { }
 
-	int GetRefCount() const {
-		return m_count;
-	}
+	int GetRefCount() const;
 
 private:
+	// add a reference
+	void IncRef();
+
+	// remove a reference, returns true if it was the last one
+	bool DecRef();
+
 	int m_count;
 };
 
@@ -369,7 +376,7 @@ public:
 	stdObject(const stdObject& other) {
 		m_refData = other.m_refData;
 		if (m_refData)
-			m_refData->m_count++;
+			m_refData->IncRef();
 	}
 
 	stdObject& operator=(const stdObject& other) {
@@ -405,6 +412,11 @@ public:
 		return m_refData == o.m_refData;
 	}
 
+	// check if the data of this object is referenced by other objects
+	bool IsShared() const {
+		return m_refData != NULL && m_refData->GetRefCount() > 1;
+	}
+
 protected:
 	// ensure that our data is not shared with anybody else: if we have no
 	// data, it is created using CreateRefData() below, if we have shared data
@@ -420,6 +432,16 @@ protected:
 	// create a new m_refData initialized with the given one
 	virtual stdObjectRefData *CloneRefData(const stdObjectRefData *data) const;
 
+	// copy on write helpers : read the data which may be shared, or get the
+	// data for modifying it, which makes it exclusive first
+	template< class T > const T *GetReadRefData() const {
+		return static_cast<const T*>(m_refData);
+	}
+	template< class T > T *GetWriteRefData() {
+		AllocExclusive();
+		return static_cast<T*>(m_refData);
+	}
+
 	stdObjectRefData *m_refData;
 };
 
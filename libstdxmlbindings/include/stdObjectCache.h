@@ -0,0 +1,226 @@
+/**
+ * @file stdObjectCache.h
+ * @brief main file for keeping the hash and the bytes of frozen generated objects
+ * @author Nicolas Macherey (nm@graymat.fr)
+ * @version 10.4
+ */
+#ifndef STD_OBJECTCACHE_H
+#define STD_OBJECTCACHE_H
+
+#include <cstddef>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/type_traits/is_base_of.hpp>
+
+#include "stdObject.h"
+#include "stdCowVector.h"
+#include "stdXmlFragment.h"
+
+/** @class stdObjectCache
+  * @brief Hash and bytes kept by a frozen generated object.
+  *
+  * Generated objects compute their hash and write their subtree each time by
+  * default. Calling the Freeze method of an object freezes the object and its
+  * object members: each of them keeps its hash, so that hashing and comparing
+  * frozen objects only compares their hashes when they differ, and keeps the bytes
+  * written for it when fragment caching is enabled, see stdXmlFragment.
+  *
+  * Calling a non const accessor of a frozen object thaws the object and the
+  * objects owning it, which compute their hash and write their subtree again until
+  * they are frozen again. Object members modified through a reference kept since
+  * their object has been frozen thaw it as well. Members which are not objects,
+  * such as strings or arrays, modified through a reference taken before their
+  * object has been frozen are not seen by the object : such references shall not
+  * be kept across Freeze, or SetDirty shall be called after modifying them.
+  *
+  * Freezing an object modifies the object and its members, it shall not be frozen
+  * while it is used by other threads. The hash and the bytes of frozen objects are
+  * only read by const methods, so frozen objects can be hashed and compared by
+  * several threads at the same time, writing them with fragment caching enabled
+  * modifies their fragment though.
+  *
+  * The cache is a single pointer, allocated when the object is frozen. Copies of a
+  * cache are empty, copies of objects are frozen on their own.
+  *
+  * @author Nicolas Macherey (nm@graymat.fr)
+  * @date 8-May-2010
+  */
+class stdObjectCache
+{
+public :
+	/** Default constructor, the object is not frozen */
+	stdObjectCache():
+		m_data(NULL)
+	{};
+
+	/** Copy constructor, the cache is not copied */
+	stdObjectCache( const stdObjectCache& ):
+		m_data(NULL)
+	{};
+
+	/** operator= overload, the cache is not copied, the generated objects thaw
+	  * themselves when they are assigned */
+	stdObjectCache& operator=( const stdObjectCache& ) {return (*this);};
+
+	/** Destructor, the members frozen for the object are no more notifying it */
+	~stdObjectCache()
+	{
+		if( m_data == NULL )
+			return;
+
+		if( m_data->node )
+			m_data->node->object = NULL;
+
+		delete m_data;
+	};
+
+	/** Check if the object is frozen */
+	bool IsFrozen() const {return m_data != NULL && m_data->frozen;};
+
+	/** Get the hash of the object, IsFrozen shall be true */
+	std::size_t GetHash() const {return m_data->hash;};
+
+	/** Get the fragment of the object, NULL if the object is not frozen */
+	const stdXmlFragment* GetXmlFragment() const
+	{
+		if( !IsFrozen() )
+			return NULL;
+
+		return &m_data->fragment;
+	};
+
+	/** Freeze the object with the given hash, this is called by the Freeze method
+	  * of generated objects once their members are frozen */
+	void Freeze( std::size_t hash )
+	{
+		DoGetData().hash = hash;
+		m_data->frozen = true;
+	};
+
+	/** Thaw the object and notify its owner, this is called by the SetDirty method
+	  * of generated objects */
+	void Thaw()
+	{
+		if( !IsFrozen() )
+			return;
+
+		m_data->frozen = false;
+		m_data->fragment.Invalidate();
+
+		if( m_data->owner && m_data->owner->object != NULL )
+			m_data->owner->notify( m_data->owner->object );
+	};
+
+	/** Freeze the given member and link it to the given object, so that thawing
+	  * the member thaws the object
+	  * @param object object owning this cache and the member
+	  * @param member member of the object
+	  */
+	template< class T , class M > void FreezeMember( T* object , M& member )
+	{
+		DoFreeze( object , member , boost::is_base_of< stdObject , M >() );
+	};
+
+	/** Freeze the items of the given array member */
+	template< class T , class M > void FreezeMember( T* object , std::vector< M >& items )
+	{
+		DoFreezeItems( object , items , boost::is_base_of< stdObject , M >() );
+	};
+
+	/** Freeze the items of the given shared array member, the items shared with
+	  * copies of the object are not frozen */
+	template< class T , class M > void FreezeMember( T* object , stdCowVector< M >& items )
+	{
+		if( !items.IsShared() )
+			DoFreezeItems( object , items.Write() , boost::is_base_of< stdObject , M >() );
+	};
+
+private :
+	/** function thawing an object */
+	typedef void (*Notifier)( void* object );
+
+	/** @struct Node
+	  * @brief Object notified by the members frozen for it, shared with them
+	  */
+	struct Node
+	{
+		Node( void* o , Notifier n ): object(o) , notify(n) {};
+
+		/** object, NULL once it has been destroyed */
+		void* object;
+
+		/** function thawing the object */
+		Notifier notify;
+	};
+
+	typedef boost::shared_ptr< Node > NodePtr;
+
+	/** @struct Data
+	  * @brief State of a frozen object, allocated on the first freeze
+	  */
+	struct Data
+	{
+		Data(): hash(0) , frozen(false) {};
+
+		/** hash of the object */
+		std::size_t hash;
+
+		/** false once the object has been modified */
+		bool frozen;
+
+		/** bytes written for the object */
+		stdXmlFragment fragment;
+
+		/** node of the object, notified by its members */
+		NodePtr node;
+
+		/** node of the owner of the object */
+		NodePtr owner;
+	};
+
+	/** Thaw the given object */
+	template< class T > static void DoNotify( void* object )
+	{
+		static_cast< T* >( object )->SetDirty();
+	};
+
+	/** Get the state of the object, it is allocated on the first call */
+	Data& DoGetData()
+	{
+		if( m_data == NULL )
+			m_data = new Data;
+
+		return *m_data;
+	};
+
+	/** Freeze an object member */
+	template< class T , class M > void DoFreeze( T* object , M& member , boost::true_type )
+	{
+		Data& data = DoGetData();
+
+		if( !data.node )
+			data.node.reset( new Node( object , &DoNotify< T > ) );
+
+		member.Freeze();
+		member.GetObjectCache().DoGetData().owner = data.node;
+	};
+
+	/** Members which are not objects are not frozen */
+	template< class T , class M > void DoFreeze( T* , M& , boost::false_type ) {};
+
+	/** Freeze the items of an array of objects */
+	template< class T , class M > void DoFreezeItems( T* object , std::vector< M >& items , boost::true_type )
+	{
+		for( typename std::vector< M >::iterator it = items.begin() ; it != items.end() ; ++it )
+			DoFreeze( object , *it , boost::true_type() );
+	};
+
+	/** Items which are not objects are not frozen */
+	template< class T , class M > void DoFreezeItems( T* , std::vector< M >& , boost::false_type ) {};
+
+	/** state of the object, NULL until it is frozen */
+	Data* m_data;
+};
+
+#endif
@@ -0,0 +1,73 @@
+/**
+ * @file stdObjectHash.h
+ * @brief main file for hashing the value of generated objects
+ * @author Nicolas Macherey (nm@graymat.fr)
+ * @version 10.4
+ */
+#ifndef STD_OBJECTHASH_H
+#define STD_OBJECTHASH_H
+
+#include <cstddef>
+#include <vector>
+#include <typeinfo>
+
+#include <boost/functional/hash.hpp>
+#include <boost/type_traits/is_base_of.hpp>
+
+#include "stdObject.h"
+#include "stdCowVector.h"
+
+/** Hash an object member, see stdHashValue */
+template< class T > inline std::size_t stdDoHashValue( const T& value , boost::true_type )
+{
+	return value.GetHash();
+}
+
+/** Hash a member which is not an object */
+template< class T > inline std::size_t stdDoHashValue( const T& value , boost::false_type )
+{
+	return boost::hash< T >()( value );
+}
+
+/** Hash a member of a generated object, this is called by the GetHash method of
+  * generated objects. Objects are hashed using their own GetHash method, so that
+  * the hash of frozen objects is reused.
+  */
+template< class T > inline std::size_t stdHashValue( const T& value )
+{
+	return stdDoHashValue( value , boost::is_base_of< stdObject , T >() );
+}
+
+/** Hash an array member, see stdHashValue */
+template< class T > inline std::size_t stdHashValue( const std::vector< T >& items )
+{
+	std::size_t hash = items.size();
+
+	for( typename std::vector< T >::const_iterator it = items.begin() ; it != items.end() ; ++it )
+		boost::hash_combine( hash , stdHashValue( *it ) );
+
+	return hash;
+}
+
+/** Hash a shared array member, see stdHashValue */
+template< class T > inline std::size_t stdHashValue( const stdCowVector< T >& items )
+{
+	return stdHashValue( items.Read() );
+}
+
+/** Combine the hash of the given member with the given hash */
+template< class T > inline void stdHashCombine( std::size_t& hash , const T& value )
+{
+	boost::hash_combine( hash , stdHashValue( value ) );
+}
+
+/** Compare two items of a generated array. Generated objects compare the hashes
+  * of frozen objects before their members, see stdObjectCache, so that searching a
+  * frozen array by value compares the members of the matching items only.
+  */
+template< class T > inline bool stdHashedEqual( const T& lhs , const T& rhs )
+{
+	return lhs == rhs;
+}
+
+#endif
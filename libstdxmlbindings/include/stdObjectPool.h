@@ -0,0 +1,188 @@
+/**
+ * @file stdObjectPool.h
+ * @brief main file for recycling the instances of generated objects
+ * @author Nicolas Macherey (nm@graymat.fr)
+ * @version 10.4
+ */
+#ifndef STD_OBJECTPOOL_H
+#define STD_OBJECTPOOL_H
+
+#include <string>
+#include <vector>
+#include <typeinfo>
+
+#include <boost/type_traits/is_base_of.hpp>
+
+#include "stdObject.h"
+#include "stdCowVector.h"
+
+/** Reset an object member to its default value, see stdResetValue */
+template< class T > inline void stdDoResetValue( T& value , boost::true_type )
+{
+	value.Reset();
+}
+
+/** Reset a member which is not an object to its default value */
+template< class T > inline void stdDoResetValue( T& value , boost::false_type )
+{
+	value = T();
+}
+
+/** Reset a member of a generated object to its default value, this is called
+  * by the Reset method of generated objects. Strings and arrays are emptied but
+  * keep their capacity, objects are reset using their own Reset method. The items
+  * of arrays are destroyed, the strings and objects they own are freed.
+  */
+template< class T > inline void stdResetValue( T& value )
+{
+	stdDoResetValue( value , boost::is_base_of< stdObject , T >() );
+}
+
+/** Reset a string member, see stdResetValue */
+inline void stdResetValue( std::string& value )
+{
+	value.clear();
+}
+
+/** Reset an array member, see stdResetValue. The storage of the array is kept,
+  * its items are destroyed. */
+template< class T > inline void stdResetValue( std::vector< T >& value )
+{
+	value.clear();
+}
+
+/** Reset a shared array member, its storage is kept if it is not shared */
+template< class T > inline void stdResetValue( stdCowVector< T >& value )
+{
+	value.clear();
+}
+
+/** @class stdObjectPoolStorage
+  * @brief Instances kept by the pools of the current thread, see stdObjectPool
+  *
+  * Each pool has its own slot in the storage of each thread. The instances kept by
+  * a thread are freed when it exits.
+  */
+class stdObjectPoolStorage
+{
+public :
+	/** Allocate the slot of a new pool */
+	static unsigned int NewSlot();
+
+	/** Get the instances released by the current thread in the given slot
+	  * @param create create the instances array if it does not exist yet
+	  * @return NULL if the array does not exist and create is false
+	  */
+	static std::vector< stdObject* >* GetItems( unsigned int slot , bool create );
+
+	/** Free the instances released by the current thread in the given slot */
+	static void Clear( unsigned int slot );
+};
+
+/** @class stdObjectPool
+  * @brief Per thread pool of recycled instances of a generated class.
+  *
+  * Generated handlers create their objects using Acquire, which returns an
+  * instance released earlier by the same thread when there is one. Released
+  * instances are reset but keep the capacity of their strings and arrays, so
+  * that decoding documents of the same shape again does not allocate the objects
+  * nor the storage of their scalar members and of their arrays of numbers.
+  *
+  * The items of arrays are destroyed by Reset : decoding an array of strings or
+  * of objects again allocates its strings and its objects, which are not taken
+  * from the pools. Only the storage of the array itself is reused.
+  *
+  * Pools are disabled by default, they are enabled for a class by giving them a
+  * capacity, which shall be done before loading documents :
+  * @code
+  * stdObjectPool< MyClass >::SetCapacity( 16 );
+  *
+  * stdXmlParseContext context;
+  * for( unsigned int i = 0; i < files.size() ; ++i ) {
+  *	MyClass* object = dynamic_cast< MyClass* >( context.LoadFile( files[i] ) );
+  *	// process object
+  *	stdObjectPool< MyClass >::Release( object );
+  * }
+  * @endcode
+  *
+  * Each thread has its own instances, so that acquiring and releasing them does
+  * not need any lock.
+  *
+  * @author Nicolas Macherey (nm@graymat.fr)
+  * @date 8-May-2010
+  */
+template< class T > class stdObjectPool
+{
+public :
+	/** Set the number of instances kept by each thread, 0 disables the pool */
+	static void SetCapacity( unsigned int capacity )
+	{
+		if( s_slot < 0 )
+			s_slot = (int) stdObjectPoolStorage::NewSlot();
+
+		s_capacity = capacity;
+	};
+
+	/** Get the number of instances kept by each thread */
+	static unsigned int GetCapacity() {return s_capacity;};
+
+	/** Get an instance released by the current thread, or a new instance if there is none */
+	static T* Acquire()
+	{
+		if( s_capacity == 0 )
+			return new T;
+
+		std::vector< stdObject* >* items = stdObjectPoolStorage::GetItems( s_slot , false );
+
+		if( items == NULL || items->empty() )
+			return new T;
+
+		T* object = static_cast< T* >( items->back() );
+		items->pop_back();
+
+		return object;
+	};
+
+	/** Give the given instance back to the pool of the current thread, it is
+	  * deleted if the pool is full or if it is an instance of a derived class
+	  */
+	static void Release( T* object )
+	{
+		if( object == NULL )
+			return;
+
+		if( s_capacity == 0 || typeid( *object ) != typeid( T ) ) {
+			delete object;
+			return;
+		}
+
+		std::vector< stdObject* >* items = stdObjectPoolStorage::GetItems( s_slot , true );
+
+		if( items->size() >= s_capacity ) {
+			delete object;
+			return;
+		}
+
+		object->Reset();
+		items->push_back( object );
+	};
+
+	/** Free the instances kept by the current thread */
+	static void Clear()
+	{
+		if( s_slot >= 0 )
+			stdObjectPoolStorage::Clear( s_slot );
+	};
+
+private :
+	/** slot of the pool in the storage of the threads, -1 until the pool is enabled */
+	static int s_slot;
+
+	/** number of instances kept by each thread */
+	static unsigned int s_capacity;
+};
+
+template< class T > int stdObjectPool< T >::s_slot = -1;
+template< class T > unsigned int stdObjectPool< T >::s_capacity = 0;
+
+#endif
@@ -0,0 +1,249 @@
+/**
+ * @file stdXmlArrayIndex.h
+ * @brief main file for indexing the items of generated arrays by one of their properties
+ * @author Nicolas Macherey (nm@graymat.fr)
+ * @version 10.4
+ */
+#ifndef STD_XMLARRAYINDEX_H
+#define STD_XMLARRAYINDEX_H
+
+#include <vector>
+#include <utility>
+
+#include <boost/unordered_map.hpp>
+
+#include "stdDefines.h"
+
+/** @class stdXmlArrayIndex
+  * @brief Hash index of the items of a generated array by one of their properties.
+  *
+  * Generated objects keep a stdXmlArrayIndex for each array given to the generator
+  * with the --index option, so that finding an item by its key does not scan the
+  * array. The index is built on the first lookup, then the Add, Set*At and Remove
+  * accessors of the array keep it up to date. Operations which move many items,
+  * such as removing an item or assigning the whole array, only invalidate it so
+  * that it is rebuilt by the next lookup.
+  *
+  * The positions found in the index are checked against the array, so that an
+  * item whose key has been changed in place is never returned for its previous
+  * key. The accessors handing out an item for modification lend its position,
+  * the key of a lent item is read again by the next lookup so that the item is
+  * found by its new key. An item modified through a reference kept after that
+  * lookup cannot be found by its new key until the index is invalidated,
+  * generated objects provide Reindex accessors for this purpose.
+  *
+  * The const lookups of generated objects do not modify their array, but they
+  * build the index and read the keys of the lent items again, so that an object
+  * shall not be searched by several threads at the same time.
+  *
+  * Copies of an index are invalid, they are rebuilt from the array of their object.
+  *
+  * @author Nicolas Macherey (nm@graymat.fr)
+  * @date 8-May-2010
+  */
+template< class K > class stdXmlArrayIndex
+{
+public :
+	/** Default constructor, the index is built on the first lookup */
+	stdXmlArrayIndex():
+		m_valid(false)
+	{};
+
+	/** Copy constructor, the index is not copied but rebuilt */
+	stdXmlArrayIndex( const stdXmlArrayIndex& ):
+		m_valid(false)
+	{};
+
+	/** operator= overload, the index is not copied but rebuilt */
+	stdXmlArrayIndex& operator=( const stdXmlArrayIndex& )
+	{
+		Invalidate();
+		return (*this);
+	};
+
+	/** Invalidate the index, it will be rebuilt by the next lookup */
+	void Invalidate()
+	{
+		m_valid = false;
+		m_positions.clear();
+		m_lent.clear();
+	};
+
+	/** Record that the item at the given position is handed out for modification
+	  * @param key key of the item before it is modified
+	  * @param position position of the item in the array
+	  */
+	void Lend( const K& key , unsigned int position )
+	{
+		if( !m_valid )
+			return;
+
+		for( unsigned int i = 0 ; i < m_lent.size() ; ++i )
+			if( m_lent[i].second == position )
+				return;
+
+		/* many items are modified, rebuilding the index is cheaper than checking them */
+		if( m_lent.size() >= stdXML_INDEX_MAX_LENT ) {
+			Invalidate();
+			return;
+		}
+
+		m_lent.push_back( std::make_pair( key , position ) );
+	};
+
+	/** Record the key of the item added at the given position */
+	void Insert( const K& key , unsigned int position )
+	{
+		if( m_valid )
+			m_positions.insert( std::make_pair( key , position ) );
+	};
+
+	/** Forget the key of the item at the given position, this is called before
+	  * the item is replaced
+	  */
+	void Erase( const K& key , unsigned int position )
+	{
+		if( !m_valid )
+			return;
+
+		/* the key of a lent item may have been changed, it is indexed by its previous key */
+		for( unsigned int i = 0 ; i < m_lent.size() ; ++i ) {
+			if( m_lent[i].second == position ) {
+				DoErase( m_lent[i].first , position );
+				m_lent.erase( m_lent.begin() + i );
+				return;
+			}
+		}
+
+		DoErase( key , position );
+	};
+
+	/** Find the first item having the given key
+	  * @param items array the index belongs to
+	  * @param key key of the item to find
+	  * @param getter accessor of the key in the items
+	  * @return the position of the item in the array, stdNOT_FOUND if no item has
+	  * the given key
+	  */
+	template< class T , class C > int Find( const std::vector< T >& items , const K& key , const K& (C::*getter)() const )
+	{
+		if( !m_valid )
+			Build( items , getter );
+		else
+			Return( items , getter );
+
+		int position = DoFind( items , key , getter );
+
+		/* all the positions of the key were stale, the keys have been changed in place */
+		if( position == stdXML_INDEX_STALE ) {
+			Build( items , getter );
+			position = DoFind( items , key , getter );
+		}
+
+		return position == stdXML_INDEX_STALE ? stdNOT_FOUND : position;
+	};
+
+	/** Find the first item equal to the given one, only the items having its key
+	  * are compared
+	  * @return the position of the item in the array, stdNOT_FOUND if no item is
+	  * equal to the given one
+	  */
+	template< class T , class C > int FindItem( const std::vector< T >& items , const T& value , const K& (C::*getter)() const )
+	{
+		int position = Find( items , (value.*getter)() , getter );
+
+		if( position == stdNOT_FOUND || items[position] == value )
+			return position;
+
+		/* several items have the key, compare all of them */
+		std::pair< iterator , iterator > range = m_positions.equal_range( (value.*getter)() );
+		position = stdNOT_FOUND;
+
+		for( iterator it = range.first ; it != range.second ; ++it )
+			if( ( position == stdNOT_FOUND || (int) it->second < position ) &&
+					it->second < items.size() && items[it->second] == value )
+				position = it->second;
+
+		return position;
+	};
+
+private :
+	typedef boost::unordered_multimap< K , unsigned int > map_type;
+	typedef typename map_type::iterator iterator;
+
+	/** returned by DoFind when the key has positions which are all stale */
+	enum { stdXML_INDEX_STALE = -2 };
+
+	/** number of lent items above which the index is rebuilt */
+	enum { stdXML_INDEX_MAX_LENT = 16 };
+
+	/** Build the index from the given array */
+	template< class T , class C > void Build( const std::vector< T >& items , const K& (C::*getter)() const )
+	{
+		m_positions.clear();
+
+		for( unsigned int i = 0 ; i < items.size() ; ++i )
+			m_positions.insert( std::make_pair( (items[i].*getter)() , i ) );
+
+		m_lent.clear();
+		m_valid = true;
+	};
+
+	/** Index the lent items by their current key */
+	template< class T , class C > void Return( const std::vector< T >& items , const K& (C::*getter)() const )
+	{
+		for( unsigned int i = 0 ; i < m_lent.size() ; ++i ) {
+			unsigned int position = m_lent[i].second;
+
+			if( position >= items.size() || (items[position].*getter)() == m_lent[i].first )
+				continue;
+
+			DoErase( m_lent[i].first , position );
+			m_positions.insert( std::make_pair( (items[position].*getter)() , position ) );
+		}
+
+		m_lent.clear();
+	};
+
+	/** Remove the given position of the key from the index */
+	void DoErase( const K& key , unsigned int position )
+	{
+		std::pair< iterator , iterator > range = m_positions.equal_range( key );
+
+		for( iterator it = range.first ; it != range.second ; ++it ) {
+			if( it->second == position ) {
+				m_positions.erase( it );
+				return;
+			}
+		}
+	};
+
+	/** Find the first valid position of the given key */
+	template< class T , class C > int DoFind( const std::vector< T >& items , const K& key , const K& (C::*getter)() const )
+	{
+		std::pair< iterator , iterator > range = m_positions.equal_range( key );
+
+		if( range.first == range.second )
+			return stdNOT_FOUND;
+
+		int position = stdXML_INDEX_STALE;
+
+		for( iterator it = range.first ; it != range.second ; ++it )
+			if( ( position < 0 || (int) it->second < position ) &&
+					it->second < items.size() && (items[it->second].*getter)() == key )
+				position = it->second;
+
+		return position;
+	};
+
+	/** positions of the items by key */
+	map_type m_positions;
+
+	/** previous keys and positions of the items handed out for modification */
+	std::vector< std::pair< K , unsigned int > > m_lent;
+
+	/** false when the index shall be rebuilt */
+	bool m_valid;
+};
+
+#endif
@@ -0,0 +1,102 @@
+/**
+ * @file stdXmlFragment.h
+ * @brief main file for keeping the bytes written for generated objects
+ * @author Nicolas Macherey (nm@graymat.fr)
+ * @version 10.4
+ */
+#ifndef STD_XMLFRAGMENT_H
+#define STD_XMLFRAGMENT_H
+
+#include <string>
+#include <cstring>
+
+/** @class stdXmlFragment
+  * @brief Bytes of the element written last for a generated object.
+  *
+  * When fragment caching is enabled in a stdXmlWriter (see
+  * stdXmlParseContext::SetFragmentCaching), generated handlers keep the bytes
+  * written for each frozen object in its fragment, see stdObjectCache. Writing the
+  * object again copies these bytes instead of writing its subtree, as long as the
+  * object has not been thawed and is written with the same element name, at the
+  * same position in the indentation and with the same encoding. Saving a frozen
+  * document again after a small change therefore only writes the objects on the
+  * path to the change and copies the bytes of the others.
+  *
+  * Copies of a fragment are empty, copies of objects are written on their own.
+  *
+  * @author Nicolas Macherey (nm@graymat.fr)
+  * @date 8-May-2010
+  */
+class stdXmlFragment
+{
+public :
+	/** Default constructor, the fragment is empty */
+	stdXmlFragment():
+		m_key(0)
+	{};
+
+	/** Copy constructor, the bytes are not copied */
+	stdXmlFragment( const stdXmlFragment& ):
+		m_key(0)
+	{};
+
+	/** operator= overload, the bytes are not copied */
+	stdXmlFragment& operator=( const stdXmlFragment& )
+	{
+		Invalidate();
+		return (*this);
+	};
+
+	/** Check if the fragment has been written */
+	bool IsValid() const {return m_key != 0;};
+
+	/** Check if the fragment can be written at the position of the given key as an
+	  * element of the given name
+	  * @param key position in the writer, see stdXmlWriter::WriteFragment
+	  * @param name name of the element
+	  */
+	bool Matches( unsigned int key , const char* name ) const
+	{
+		if( key != m_key )
+			return false;
+
+		size_t length = strlen( name );
+
+		if( m_bytes.size() < length + 2 || m_bytes.compare( 1 , length , name ) != 0 )
+			return false;
+
+		char next = m_bytes[length + 1];
+		return next == ' ' || next == '>' || next == '/';
+	};
+
+	/** Get the bytes of the element, IsValid shall be true */
+	const std::string& Get() const {return m_bytes;};
+
+	/** Keep the bytes written for the object
+	  * @param key position of the element in the writer
+	  * @param data bytes of the element, from its start tag to its end tag
+	  * @param length number of bytes
+	  */
+	void Set( unsigned int key , const char* data , size_t length ) const
+	{
+		m_bytes.assign( data , length );
+		m_key = key;
+	};
+
+	/** Forget the bytes, this is called when the object is thawed. The storage
+	  * is kept for writing the object again. */
+	void Invalidate()
+	{
+		m_key = 0;
+		m_bytes.clear();
+	};
+
+private :
+	/** position the bytes have been written at, 0 if they shall be written again */
+	mutable unsigned int m_key;
+
+	/** bytes of the element */
+	mutable std::string m_bytes;
+};
+
+#endif
@@ -0,0 +1,226 @@
+/**
+ * @file stdXmlLazyMembers.h
+ * @brief main file for loading the members of generated objects on first access
+ * @author Nicolas Macherey (nm@graymat.fr)
+ * @version 10.4
+ */
+#ifndef STD_XMLLAZYMEMBERS_H
+#define STD_XMLLAZYMEMBERS_H
+
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/type_traits/is_base_of.hpp>
+
+#include "stdDefines.h"
+#include "stdObject.h"
+#include "stdCowVector.h"
+
+/* imports */
+class stdXmlLazySource;
+
+/** shared pointer on a stdXmlLazySource, see stdXmlLazySource */
+typedef boost::shared_ptr< stdXmlLazySource > stdXmlLazySourcePtr;
+
+/** @struct stdXmlLazyEntry
+  * @brief Member whose loading has been deferred
+  */
+struct stdXmlLazyEntry
+{
+	/** document the node belongs to */
+	stdXmlLazySourcePtr source;
+
+	/** element to load the member from, first element of the member for arrays */
+	xmlNode* node;
+
+	/** class name of the member */
+	const char* className;
+};
+
+/** @class stdXmlLazyMembers
+  * @brief Members of a generated object which have not been loaded yet.
+  *
+  * When a document is loaded lazily (see stdXmlParseContext::SetLazy), generated
+  * handlers do not create the object members of the objects they read : they
+  * record the elements of these members in the object's stdXmlLazyMembers, which
+  * keep the document alive. A member is created from its element the first time
+  * its Get accessor is called, so that the parts of the document which are never
+  * accessed are never converted. The document is freed once all the members
+  * recorded from it have been loaded or their objects deleted.
+  *
+  * Members are identified by their element name. Setting a member cancels its
+  * loading. Copies of an object load their members on their own.
+  *
+  * Loading a member modifies its object, so an object shall not be accessed by
+  * several threads before its members are loaded, generated objects can load
+  * all of them at once using LoadLazyMembers. Different objects of a document
+  * can be loaded by different threads.
+  *
+  * @author Nicolas Macherey (nm@graymat.fr)
+  * @date 8-May-2010
+  */
+class stdXmlLazyMembers
+{
+public :
+	/** Default constructor */
+	stdXmlLazyMembers():
+		m_entries(NULL)
+	{};
+
+	/** Copy constructor, the copy loads the members on its own */
+	stdXmlLazyMembers( const stdXmlLazyMembers& rhs ):
+		m_entries( rhs.m_entries != NULL ? new std::vector< stdXmlLazyEntry >( *rhs.m_entries ) : NULL )
+	{};
+
+#ifdef stdHAS_RVALUE_REFERENCES
+	/** Move constructor, the members not loaded are taken from rhs */
+	stdXmlLazyMembers( stdXmlLazyMembers&& rhs ) noexcept:
+		m_entries( rhs.m_entries )
+	{
+		rhs.m_entries = NULL;
+	};
+
+	/** Move assignment, the members not loaded are taken from rhs */
+	stdXmlLazyMembers& operator=( stdXmlLazyMembers&& rhs ) noexcept
+	{
+		if( this != &rhs ) {
+			Clear();
+			m_entries = rhs.m_entries;
+			rhs.m_entries = NULL;
+		}
+
+		return (*this);
+	};
+#endif
+
+	/** Destructor, releases the documents of the members not loaded */
+	~stdXmlLazyMembers()
+	{
+		delete m_entries;
+	};
+
+	/** operator= overload */
+	stdXmlLazyMembers& operator=( const stdXmlLazyMembers& rhs );
+
+	/** Check if some members have not been loaded yet */
+	bool IsPending() const {return m_entries != NULL;};
+
+	/** Defer the loading of the member read from the given element
+	  * @param source document the element belongs to
+	  * @param node element of the member, a previous element of the member is
+	  * replaced
+	  * @param className class name of the member, it shall be a static string
+	  */
+	void Defer( const stdXmlLazySourcePtr& source , xmlNode* node , const char* className );
+
+	/** Defer the loading of the array member read from the given element, all
+	  * the sibling elements having its name are loaded in the array.
+	  * @param source document the element belongs to
+	  * @param node element of the member, nothing is done if the member has
+	  * already been deferred
+	  * @param className class name of the array items, it shall be a static string
+	  */
+	void DeferRun( const stdXmlLazySourcePtr& source , xmlNode* node , const char* className );
+
+	/** Load the given member if it has been deferred, this is called by the Get
+	  * accessors of generated objects. Nothing is done for members which are not
+	  * objects, they are never deferred.
+	  * @param name element name of the member
+	  * @param value member to load
+	  * @param has [out] set to false if the member cannot be loaded
+	  */
+	template< class T > void Load( const char* name , T& value , bool& has )
+	{
+		if( m_entries != NULL )
+			DoLoad( name , value , has , boost::is_base_of< stdObject , T >() );
+	};
+
+	/** Load the given array member if it has been deferred, see Load */
+	template< class T > void Load( const char* name , std::vector< T >& items , bool& has )
+	{
+		if( m_entries != NULL )
+			DoLoadRun( name , items , has , boost::is_base_of< stdObject , T >() );
+	};
+
+	/** Load the given shared array member if it has been deferred, see Load */
+	template< class T > void Load( const char* name , stdCowVector< T >& items , bool& has )
+	{
+		if( m_entries != NULL )
+			DoLoadRun( name , items.Write() , has , boost::is_base_of< stdObject , T >() );
+	};
+
+	/** Cancel the loading of the given member, this is called when the member is set */
+	void Cancel( const char* name )
+	{
+		if( m_entries != NULL )
+			DoTake( name , NULL );
+	};
+
+	/** Cancel the loading of all members */
+	void Clear();
+
+private :
+	/** Members which are not objects are never deferred */
+	template< class T > void DoLoad( const char* , T& , bool& , boost::false_type )
+	{};
+
+	/** Load the given object member */
+	template< class T > void DoLoad( const char* name , T& value , bool& has , boost::true_type )
+	{
+		stdXmlLazyEntry entry;
+
+		if( DoTake( name , &entry ) )
+			has = DoLoadNode( entry , &value ) != NULL;
+	};
+
+	/** Arrays of values which are not objects are never deferred */
+	template< class T > void DoLoadRun( const char* , std::vector< T >& , bool& , boost::false_type )
+	{};
+
+	/** Load the given array of objects */
+	template< class T > void DoLoadRun( const char* name , std::vector< T >& items , bool& has , boost::true_type )
+	{
+		stdXmlLazyEntry entry;
+
+		if( !DoTake( name , &entry ) )
+			return;
+
+		std::vector< xmlNode* > nodes;
+		DoCollectRun( entry.node , nodes );
+
+		size_t base = items.size();
+		items.resize( base + nodes.size() );
+
+		std::vector< stdObject* > instances( nodes.size() );
+		std::vector< stdObject* > results;
+
+		for( size_t i = 0; i < nodes.size() ; ++i )
+			instances[i] = &items[base + i];
+
+		DoLoadNodes( entry , nodes , instances , results );
+
+		has = stdXmlKeepCreated( items , base , results );
+	};
+
+	/** Remove the entry of the given member
+	  * @param name element name of the member
+	  * @param entry [out] removed entry if not NULL
+	  * @return false if the member has not been deferred
+	  */
+	bool DoTake( const char* name , stdXmlLazyEntry* entry );
+
+	/** Create the given instance from the entry's element */
+	static stdObject* DoLoadNode( const stdXmlLazyEntry& entry , stdObject* instance );
+
+	/** Create the given instances from the given elements of the entry's document */
+	static void DoLoadNodes( const stdXmlLazyEntry& entry , const std::vector< xmlNode* >& nodes ,
+			const std::vector< stdObject* >& instances , std::vector< stdObject* >& results );
+
+	/** Get the given element and the following sibling elements having its name */
+	static void DoCollectRun( xmlNode* node , std::vector< xmlNode* >& nodes );
+
+	/** members not loaded yet, NULL if there is none */
+	std::vector< stdXmlLazyEntry >* m_entries;
+};
+
+#endif
@@ -0,0 +1,81 @@
+/**
+ * @file stdXmlLazySource.h
+ * @brief main file for keeping the documents loaded lazily
+ * @author Nicolas Macherey (nm@graymat.fr)
+ * @version 10.4
+ */
+#ifndef STD_XMLLAZYSOURCE_H
+#define STD_XMLLAZYSOURCE_H
+
+#include <vector>
+
+#include <boost/enable_shared_from_this.hpp>
+#include <boost/thread/recursive_mutex.hpp>
+
+#include "stdXmlLazyMembers.h"
+#include "stdXmlParseContext.h"
+
+/** @class stdXmlLazySource
+  * @brief Document loaded lazily, kept until all its deferred members are loaded.
+  *
+  * The source is shared by the stdXmlLazyMembers of the objects read from the
+  * document and frees it when the last of them releases it. Members are loaded in
+  * a context of the source, one at a time, so objects of the same document can be
+  * accessed from several threads.
+  *
+  * @author Nicolas Macherey (nm@graymat.fr)
+  * @date 8-May-2010
+  */
+class stdXmlLazySource : public boost::enable_shared_from_this< stdXmlLazySource >
+{
+public :
+	/** Constructor, the source takes the ownership of the given document
+	  * @param doc document loaded lazily
+	  * @param threads number of threads for loading runs of elements, see
+	  * stdXmlParseContext::SetParallelism
+	  * @param threshold minimal number of elements loaded in parallel
+	  */
+	stdXmlLazySource( xmlDoc* doc , unsigned int threads , unsigned int threshold );
+
+	/** Destructor, frees the document */
+	~stdXmlLazySource();
+
+	/** Create the given instance from the given element of the document, the
+	  * object members of the instance are deferred in turn.
+	  */
+	stdObject* Load( xmlNode* node , const std::string& className , stdObject* instance );
+
+	/** Create the given instances from the given elements of the document, see
+	  * stdXmlParseContext::CreateResFromNodes
+	  */
+	void LoadNodes( const std::vector< xmlNode* >& nodes , const std::string& className ,
+			const std::vector< stdObject* >& instances , std::vector< stdObject* >& results );
+
+	/** Get the document */
+	xmlDoc* GetDocument() {return m_doc;};
+
+private :
+	/** sources cannot be copied */
+	stdXmlLazySource( const stdXmlLazySource& );
+	stdXmlLazySource& operator=( const stdXmlLazySource& );
+
+	/** Get the context members are loaded in, it is created on the first call */
+	stdXmlParseContext* DoGetContext();
+
+	/** document loaded lazily */
+	xmlDoc* m_doc;
+
+	/** context members are loaded in, NULL until the first member is loaded */
+	stdXmlParseContext* m_context;
+
+	/** number of threads for loading runs of elements */
+	unsigned int m_threads;
+
+	/** minimal number of elements loaded in parallel */
+	unsigned int m_threshold;
+
+	/** mutex serializing the loading of members */
+	boost::recursive_mutex m_mutex;
+};
+
+#endif
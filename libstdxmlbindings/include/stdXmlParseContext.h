@@ -0,0 +1,335 @@
+/**
+ * @file stdXmlParseContext.h
+ * @brief main file for reading and writing xml documents in a reentrant way
+ * @author Nicolas Macherey (nm@graymat.fr)
+ * @version 10.4
+ */
+#ifndef STD_XMLPARSECONTEXT_H
+#define STD_XMLPARSECONTEXT_H
+
+#include "stdXmlReader.h"
+#include "stdXmlLazyMembers.h"
+#include "stdXmlProjection.h"
+
+/* imports */
+struct stdXmlParallelRun;
+
+/** @class stdXmlParseContext
+  * @brief Context for reading and writing documents using the registered stdXmlHandler's
+  *
+  * The context keeps everything related to the documents it reads or writes : the
+  * document being processed, its own instances of the handlers which are created the
+  * first time they are needed, and the index of handlers by interned names.
+  * Contexts do not share any mutable state, so several threads can load documents
+  * at the same time as long as each one uses its own context. A context shall not
+  * be used by several threads at once.
+  *
+  * The context works on the handlers registered in the stdXmlReader when it has
+  * been created, handlers registered later are not visible to it.
+  *
+  * @code
+  * stdXmlParseContext context;
+  * for( unsigned int i = 0; i < files.size() ; ++i ) {
+  *	stdObject* object = context.LoadFile( files[i] );
+  *	// process object
+  *	delete object;
+  * }
+  * @endcode
+  *
+  * @author Nicolas Macherey (nm@graymat.fr)
+  * @date 8-May-2010
+  */
+class stdXmlParseContext
+{
+	/** give stdXmlPushParser, stdXmlLazySource and stdXmlHandler our private members access */
+	friend class stdXmlPushParser;
+	friend class stdXmlLazySource;
+	friend class stdXmlHandler;
+
+public :
+	/** Constructor, the context works on the current dispatch table of the
+	  * stdXmlReader.
+	  */
+	stdXmlParseContext();
+
+	/** Destructor, frees the handlers created by the context */
+	~stdXmlParseContext();
+
+	/** Load the given xml file, see stdXmlReader::LoadFile */
+	stdObject* LoadFile( const std::string& file );
+
+	/** Load xml from a string, see stdXmlReader::Load */
+	stdObject* Load( const std::string& data );
+
+	/** Load the given xml file in streaming mode, see stdXmlReader::LoadFileStreaming */
+	stdObject* LoadFileStreaming( const std::string& file );
+
+	/** Load xml from a string in streaming mode, see stdXmlReader::LoadFileStreaming */
+	stdObject* LoadStreaming( const std::string& data );
+
+	/** Read the document root from the given reader and free it
+	  * @param reader reader positioned before the document root
+	  */
+	stdObject* LoadStream( xmlTextReaderPtr reader );
+
+	/** Save the resource in the given file, see stdXmlReader::SaveFile */
+	void SaveFile( const std::string& file , stdObject* resource );
+
+	/** Get the xml string from your resource, see stdXmlReader::StringSerialize */
+	std::string StringSerialize( stdObject* resource );
+
+	/** Write the resource as a whole document in the given writer, see stdXmlReader::Save */
+	void Save( stdXmlWriter& writer , stdObject* resource );
+
+	/** Creates a resource from the given node using the context's handlers */
+	stdObject *CreateResFromNode(xmlNode *node , const std::string& className, stdObject *resource = NULL, stdXmlHandler* handlerToUse = NULL)
+	{
+		return node ? DoCreateResFromNode(node , className , resource, handlerToUse)
+			: NULL;
+	}
+
+	/** Creates a resource from the element the given reader is positioned on, see
+	  * stdXmlReader::CreateResFromStream
+	  */
+	stdObject *CreateResFromStream(xmlTextReaderPtr reader , const std::string& className, stdObject *resource = NULL, stdXmlHandler* handlerToUse = NULL)
+	{
+		return reader ? DoCreateResFromStream(reader , className , resource, handlerToUse)
+			: NULL;
+	}
+
+	/** Write the given resource into a node using the context's handlers */
+	xmlNode* WriteResource( stdObject* resource, const char* nodename = NULL , stdXmlHandler* handlerToUse = NULL )
+	{
+		return resource ? DoWriteResource(resource, nodename, handlerToUse)
+			: NULL;
+	}
+
+	/** Write the given resource in the given writer using the context's handlers
+	  * @return false if no handler can write the resource
+	  */
+	bool WriteResourceToStream( stdObject* resource, stdXmlWriter* writer, const char* nodename = NULL , stdXmlHandler* handlerToUse = NULL )
+	{
+		return resource ? DoWriteResourceToStream(resource, writer, nodename, handlerToUse)
+			: false;
+	}
+
+	/** Creates the resources of the given nodes in the given instances.
+	  * When parallel loading is enabled and there are enough nodes, the nodes are
+	  * shared between several threads each working in its own context, which
+	  * cannot fan out again.
+	  * @param nodes nodes to create the resources from
+	  * @param className class name of the resources to create
+	  * @param instances instance to fill for each node
+	  * @param results [out] result of CreateResFromNode for each node
+	  */
+	void CreateResFromNodes( const std::vector< xmlNode* >& nodes , const std::string& className ,
+			const std::vector< stdObject* >& instances , std::vector< stdObject* >& results );
+
+	/** Enable or disable parallel loading.
+	  * Large runs of sibling elements read by generated handlers are then converted
+	  * by several threads. Handlers converting the elements shall not depend on
+	  * each other, which is the case of generated handlers.
+	  * @param threads number of threads, 0 for one per core and 1 for disabling
+	  * parallel loading
+	  * @param threshold minimal number of elements converted in parallel
+	  */
+	void SetParallelism( unsigned int threads , unsigned int threshold = stdXML_PARALLEL_THRESHOLD );
+
+	/** Set the libxml2 parser options used for reading documents.
+	  * Useful options are :
+	  * - XML_PARSE_COMPACT : store short text in the nodes, set by default
+	  * - XML_PARSE_NOBLANKS : drop the blank text nodes between elements so that
+	  * generated handlers do not have to skip them
+	  * - XML_PARSE_HUGE : accept documents with very large nodes or more than
+	  * 2GB long, large files can only be loaded with this option
+	  * - XML_PARSE_NODICT : do not intern the strings of the documents in a
+	  * dictionary, names are then compared by content instead of by pointer
+	  * @param options combination of xmlParserOption
+	  */
+	void SetParseOptions( int options ) {m_options = options;};
+
+	/** Get the libxml2 parser options used for reading documents */
+	int GetParseOptions() const {return m_options;};
+
+	/** Enable or disable lazy loading.
+	  * Generated handlers then do not create the object members of the objects
+	  * they read, the document is kept and each member is created the first time
+	  * it is accessed, see stdXmlLazyMembers. This only applies to documents loaded
+	  * as a whole, streaming modes and record readers always load eagerly.
+	  */
+	void SetLazy( bool lazy ) {m_lazy = lazy;};
+
+	/** Check if lazy loading is enabled, see SetLazy */
+	bool IsLazy() const {return m_lazy;};
+
+	/** Enable or disable fragment caching in SaveFile and StringSerialize.
+	  * Frozen generated objects then keep the bytes written for them, and saving
+	  * them again only writes the objects thawed since, see stdObjectCache. Each
+	  * object keeps the bytes of its subtree, and SaveFile and StringSerialize
+	  * do not write the same bytes, so that alternating them writes everything.
+	  */
+	void SetFragmentCaching( bool caching ) {m_caching = caching;};
+
+	/** Check if fragment caching is enabled, see SetFragmentCaching */
+	bool IsFragmentCaching() const {return m_caching;};
+
+	/** Set the projection of the documents loaded, generated handlers then only
+	  * read the elements and attributes on the paths of the projection, see
+	  * stdXmlProjection. When the document is read in streaming mode, the skipped
+	  * elements are not even parsed into nodes. Lazy loading only defers the
+	  * members of the elements read entirely.
+	  * @param projection projection to apply, it shall outlive the loads, NULL
+	  * for reading the documents entirely
+	  */
+	void SetProjection( const stdXmlProjection* projection ) {m_projection = projection;};
+
+	/** Get the projection of the documents loaded, NULL if there is none */
+	const stdXmlProjection* GetProjection() const {return m_projection;};
+
+	/** Get the source of the document being loaded lazily, empty if the document
+	  * being read is not loaded lazily
+	  */
+	const stdXmlLazySourcePtr& GetLazySource() const {return m_lazySource;};
+
+	/** Check if the given xmlNode can be handled or not */
+	bool HasHandlerFor( xmlNode* node ) {return DoFindHandler( node ) != NULL;};
+
+	/** Check if the names of the given node are interned in the dictionary of
+	  * the dispatch table, which is the case of the documents being loaded by
+	  * the context.
+	  */
+	bool IsInterned( xmlNode* node ) const
+	{
+		return m_indexInterned && node->doc != NULL && node->doc->dict == m_indexDict;
+	};
+
+	/** Get the document being read, NULL if there is none */
+	xmlDoc* GetDocument() {return m_doc;};
+
+	/** Get the root node of the document being read */
+	xmlNode* GetRoot() {return m_root;};
+
+private :
+	/** contexts cannot be copied */
+	stdXmlParseContext( const stdXmlParseContext& );
+	stdXmlParseContext& operator=( const stdXmlParseContext& );
+
+	/** Read the root of the given document and free it */
+	stdObject* DoLoadDocument( xmlDoc* doc );
+
+	/** Get the projection of the document root, NULL when it is read entirely */
+	const stdXmlProjection* DoGetRootCursor() const
+	{
+		return m_projection != NULL && !m_projection->IsComplete() ? m_projection : NULL;
+	};
+
+	/** Parse the document in the given buffer, which is not copied
+	  * @param data document to parse
+	  * @param size size of the document
+	  * @param url url of the document, used for error messages and relative uris
+	  * @return the parsed document, NULL if it cannot be parsed
+	  */
+	xmlDoc* DoParseMemory( const char* data , size_t size , const char* url );
+
+	/** Create a parser whose documents inherit the names interned in the
+	  * dispatch table, the caller has to free it using xmlFreeParserCtxt.
+	  */
+	xmlParserCtxt* DoCreateParser();
+
+	/** Make the documents of the given parser inherit the names interned in the
+	  * dispatch table, this shall be done before the parser reads anything.
+	  */
+	void DoSetParserDict( xmlParserCtxt* parser );
+
+	/** Creates a stdObject from a node */
+	stdObject *DoCreateResFromNode(xmlNode* node,
+				  const std::string& className,
+                                  stdObject *resource,
+                                  stdXmlHandler *handlerToUse = NULL);
+
+	/** Creates a stdObject from the element the reader is positioned on */
+	stdObject *DoCreateResFromStream(xmlTextReaderPtr reader,
+				  const std::string& className,
+                                  stdObject *resource,
+                                  stdXmlHandler *handlerToUse = NULL);
+
+	/** This method is used to write resource to into a node */
+	xmlNode* DoWriteResource( stdObject* resource, const char* nodename = NULL , stdXmlHandler* handlerToUse = NULL );
+
+	/** This method is used to write resource into a writer */
+	bool DoWriteResourceToStream( stdObject* resource, stdXmlWriter* writer, const char* nodename = NULL , stdXmlHandler* handlerToUse = NULL );
+
+	/** Get the context's instance of the handler in the given slot of the
+	  * dispatch table, it is created on the first call.
+	  */
+	stdXmlHandler* DoGetHandler( unsigned int slot );
+
+	/** Find the handler able to create the given class */
+	stdXmlHandler* DoFindHandler( const std::string& className );
+
+	/** Find the handler able to read the given node */
+	stdXmlHandler* DoFindHandler( xmlNode* node );
+
+	/** Find the handler able to write the given resource */
+	stdXmlHandler* DoFindHandler( stdObject* resource );
+
+	/** Convert the nodes of the given run in a new context until all of them have
+	  * been claimed, this is the main function of the threads of parallel runs.
+	  */
+	static void DoRunWorker( stdXmlParallelRun* run );
+
+	/** Use the given dictionary for indexing handlers by interned names, the
+	  * index by interned names is cleared.
+	  * @return the previously used dictionary
+	  */
+	xmlDict* DoSetIndexDict( xmlDict* dict );
+
+	/** handlers dispatch table */
+	stdXmlDispatchTablePtr m_table;
+
+	/** handlers instances by slot, NULL until they are used */
+	stdArrayXmlHandler m_handlers;
+
+	/** index of handlers by element name pointers interned in m_indexDict */
+	stdHashTable* m_dictIndex;
+
+	/** dictionary of the document being loaded */
+	xmlDict* m_indexDict;
+
+	/** true when m_indexDict inherits the names of the dispatch table */
+	bool m_indexInterned;
+
+	/** number of threads used for loading runs of elements */
+	unsigned int m_threads;
+
+	/** minimal number of elements loaded in parallel */
+	unsigned int m_threshold;
+
+	/** libxml2 parser options */
+	int m_options;
+
+	/** true for loading documents lazily */
+	bool m_lazy;
+
+	/** true for keeping the bytes written for the objects */
+	bool m_caching;
+
+	/** source of the document being loaded lazily */
+	stdXmlLazySourcePtr m_lazySource;
+
+	/** projection of the documents loaded */
+	const stdXmlProjection* m_projection;
+
+	/** projection of the element whose resource is being created, NULL when it
+	  * is read entirely
+	  */
+	const stdXmlProjection* m_cursor;
+
+	/** XML document */
+	xmlDoc* m_doc;
+
+	/** XML root node */
+	xmlNode* m_root;
+};
+
+#endif
@@ -0,0 +1,84 @@
+/**
+ * @file stdXmlProjection.h
+ * @brief main file for loading only some members of the documents
+ * @author Nicolas Macherey (nm@graymat.fr)
+ * @version 10.4
+ */
+#ifndef STD_XMLPROJECTION_H
+#define STD_XMLPROJECTION_H
+
+#include <string>
+#include <vector>
+#include <utility>
+
+/** @class stdXmlProjection
+  * @brief Set of element paths telling generated handlers which members to read.
+  *
+  * Paths are given from the children of the document root, using the local names
+  * of the elements separated by '/'. The last step of a path can be an attribute
+  * name prefixed by '@'. The elements and attributes which are not on any path
+  * are skipped by generated handlers, the element ending a path is read entirely.
+  *
+  * @code
+  * stdXmlProjection projection;
+  * projection.Add( "personHolidays/person/age" );
+  * projection.Add( "personHolidays/person/@lastname" );
+  *
+  * stdXmlParseContext context;
+  * context.SetProjection( &projection );
+  * stdObject* object = context.LoadFile( file );
+  * @endcode
+  *
+  * Each step of the paths is itself a stdXmlProjection giving the projection of
+  * the elements of this step.
+  *
+  * @author Nicolas Macherey (nm@graymat.fr)
+  * @date 8-May-2010
+  */
+class stdXmlProjection
+{
+public :
+	/** Default constructor, the projection keeps nothing until paths are added */
+	stdXmlProjection():
+		m_complete(false)
+	{};
+
+	/** Destructor */
+	~stdXmlProjection();
+
+	/** Add the given path to the projection
+	  * @param path element names separated by '/', ended by an optional attribute
+	  * name prefixed by '@', an empty path keeps everything
+	  */
+	void Add( const std::string& path );
+
+	/** Find the projection of the given child element
+	  * @return NULL if the child element is skipped
+	  */
+	const stdXmlProjection* FindChild( const char* name ) const;
+
+	/** Check if the given attribute is read */
+	bool HasAttribute( const char* name ) const;
+
+	/** Check if the elements of this step are read entirely */
+	bool IsComplete() const {return m_complete;};
+
+private :
+	/** projections cannot be copied */
+	stdXmlProjection( const stdXmlProjection& );
+	stdXmlProjection& operator=( const stdXmlProjection& );
+
+	/** Get the projection of the given child element, create it if needed */
+	stdXmlProjection* DoGetChild( const std::string& name );
+
+	/** projections of the child elements read, by element name */
+	std::vector< std::pair< std::string , stdXmlProjection* > > m_children;
+
+	/** attributes read */
+	std::vector< std::string > m_attributes;
+
+	/** true when the elements are read entirely */
+	bool m_complete;
+};
+
+#endif
@@ -0,0 +1,137 @@
+/**
+ * @file stdXmlPushParser.h
+ * @brief main file for reading xml documents given incrementally
+ * @author Nicolas Macherey (nm@graymat.fr)
+ * @version 10.4
+ */
+#ifndef STD_XMLPUSHPARSER_H
+#define STD_XMLPUSHPARSER_H
+
+#include <deque>
+
+#include "stdXmlReader.h"
+#include "stdXmlParseContext.h"
+
+/** @class stdXmlPushParser
+  * @brief Reads a document whose content is given piece by piece
+  *
+  * Documents received from sockets or pipes do not have to be gathered in memory
+  * before being loaded : each piece is given to Feed as soon as it is received
+  * and is parsed right away by a libxml2 push parser.
+  *
+  * In document mode the root object is created by Finish once the whole document
+  * has been given, as Load would do.
+  *
+  * In records mode the children of the root node are converted into records while
+  * the document is still being received, like with a stdXmlRecordReader. A record
+  * is converted once the parser has gone past its end tag and its nodes are freed
+  * right away, so that only the records not yet read have to exist in memory.
+  * Records are read using Next, those returned by Next are owned by the parser and
+  * are deleted on the next call to Next or when the parser is destroyed, unless
+  * you take their ownership using Release.
+  *
+  * @code
+  * stdXmlPushParser* parser = stdXmlReader::Get()->OpenPush( true );
+  * while( ( size = read( fd , buffer , sizeof(buffer) ) ) > 0 ) {
+  *	parser->Feed( buffer , size );
+  *	while( stdObject* record = parser->Next() ) {
+  *		// process record
+  *	}
+  * }
+  * parser->Finish();
+  * while( stdObject* record = parser->Next() ) {
+  *	// process record
+  * }
+  * delete parser;
+  * @endcode
+  *
+  * @author Nicolas Macherey (nm@graymat.fr)
+  * @date 8-May-2010
+  */
+class stdXmlPushParser
+{
+	friend class stdXmlReader;
+
+public :
+	/** Destructor, deletes the records which were not released */
+	~stdXmlPushParser();
+
+	/** Parse the next piece of the document, the data is not kept.
+	  * In records mode, the records completed by this piece are converted and
+	  * can be read using Next.
+	  */
+	void Feed( const char* data , size_t size );
+
+	/** Parse the next piece of the document, see Feed */
+	void Feed( const std::string& data ) {Feed( data.data() , data.size() );};
+
+	/** Terminate the document once all its pieces have been given.
+	  * @return in document mode the root object of the document, you have to
+	  * delete it once done. In records mode NULL, the last records can be read
+	  * using Next.
+	  */
+	stdObject* Finish();
+
+	/** Get the next record converted by Feed or Finish in records mode.
+	  * The previous record is deleted unless it has been released.
+	  * @return the next record or NULL if no record is available yet
+	  */
+	stdObject* Next();
+
+	/** Get the record returned by the last call to Next */
+	stdObject* GetCurrent() {return m_current;};
+
+	/** Take the ownership of the current record, it will no longer be deleted
+	  * by the stdXmlPushParser.
+	  */
+	stdObject* Release();
+
+	/** Check if Finish has been called */
+	bool IsFinished() const {return m_finished;};
+
+	/** Get the name of the document root node, empty until it has been parsed */
+	const std::string& GetRootName() const {return m_rootName;};
+
+private :
+	/** Constructor, only stdXmlReader can build push parsers
+	  * @param records true for converting the children of the root node as records
+	  * @param className class name of the records to create, if empty the handler
+	  * is found from the record node
+	  */
+	stdXmlPushParser( bool records , const std::string& className );
+
+	/** Parse the given piece of the document and check for errors */
+	void DoParseChunk( const char* data , size_t size , bool terminate );
+
+	/** Convert the children of the root node which have been completely parsed
+	  * into records and free them.
+	  * @param all true for converting all children, once the document is complete
+	  */
+	void DoReadRecords( bool all );
+
+	/** libxml2 push parser */
+	xmlParserCtxt* m_parser;
+
+	/** context the objects are created in */
+	stdXmlParseContext m_context;
+
+	/** true in records mode */
+	bool m_records;
+
+	/** class name of the records */
+	std::string m_className;
+
+	/** document root node name */
+	std::string m_rootName;
+
+	/** records converted and not yet read */
+	std::deque< stdObject* > m_pending;
+
+	/** current record */
+	stdObject* m_current;
+
+	/** true once Finish has been called */
+	bool m_finished;
+};
+
+#endif
@@ -8,16 +8,38 @@
 #ifndef STD_XMLREADER_H
 #define STD_XMLREADER_H
 
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <libxml/dict.h>
+
 #include "stdSingleton.h"
 #include "stdDefines.h"
 #include "stdException.h"
 #include "stdObject.h"
+#include "stdHashTable.h"
+#include "stdXmlWriter.h"
+#include "stdXmlLazyMembers.h"
+#include "stdXmlProjection.h"
+#include "stdObjectPool.h"
 
 /* imports */
 class stdXmlHandler;
 class stdXmlReader;
+class stdXmlRecordReader;
+class stdXmlPushParser;
+class stdXmlParseContext;
 class stdObject;
 
+/** default minimal number of sibling elements converted in parallel */
+#define stdXML_PARALLEL_THRESHOLD 64
+
+/** default libxml2 parser options (xmlParserOption) of the new stdXmlParseContext's.
+  * Short text is stored in the nodes themselves, this does not change the
+  * documents read.
+  */
+#define stdXML_PARSE_DEFAULT XML_PARSE_COMPACT
+
 /** define XmlHandler constructor methods for building generically any kind of handlers */
 typedef stdXmlHandler* (*stdXmlHandlerConstructor)();
 
@@ -40,15 +62,18 @@ struct stdXmlHandlerRegistration
 	  **************************************************************/
 	/** default constructor */
 	stdXmlHandlerRegistration( ) : 
-		ctor(0),dtor(0)
+		ctor(0),dtor(0),names(NULL)
 	{};
 
 	/** copy constructor */
 	stdXmlHandlerRegistration( const stdXmlHandlerRegistration& rhs ):
 		name(rhs.name),
 		description(rhs.description),
+		className(rhs.className),
+		nodeName(rhs.nodeName),
 		ctor(rhs.ctor),
-		dtor(rhs.dtor)
+		dtor(rhs.dtor),
+		names(rhs.names)
 	{};
 
 	/** operator= overload */
@@ -56,8 +81,11 @@ struct stdXmlHandlerRegistration
 	{
 		name = rhs.name;
 		description = rhs.description;
+		className = rhs.className;
+		nodeName = rhs.nodeName;
 		ctor = rhs.ctor;
 		dtor = rhs.dtor;
+		names = rhs.names;
 		return (*this);
 	}
 
@@ -67,8 +95,16 @@ struct stdXmlHandlerRegistration
 	  **************************************************************/
 	std::string name;
 	std::string description;
+	/** name of the class created by the handler, empty if not declared */
+	std::string className;
+	/** name of the element read by the handler, empty if not declared */
+	std::string nodeName;
 	stdXmlHandlerConstructor ctor;
 	stdXmlHandlerDestructor dtor;
+	/** NULL terminated list of the element and attribute names read by the
+	  * handler, NULL if not declared. The list is not copied.
+	  */
+	const char* const* names;
 };
 
 /** now we just have to define a map of stdXmlHandlerRegistration in order to manage them in
@@ -76,15 +112,146 @@ struct stdXmlHandlerRegistration
   */
 typedef std::map< std::string , stdXmlHandlerRegistration > stdXmlHandlerRegistrationMap;
 
+/** @class stdXmlHandlerEntry
+  * @brief entry of a stdXmlDispatchTable, it gives the slot of a registered handler
+  * in the table so that it can be stored in the table's hash indexes.
+  * @author Nicolas Macherey (nm@graymat.fr)
+  * @date 8-May-2010
+  */
+class stdXmlHandlerEntry : public stdObject
+{
+public :
+	/** constructor */
+	stdXmlHandlerEntry( const stdXmlHandlerRegistration& info , unsigned int index ):
+		stdObject(),
+		registration(info),
+		slot(index)
+	{};
+
+	/** registration of the handler */
+	stdXmlHandlerRegistration registration;
+
+	/** slot of the handler in the dispatch table */
+	unsigned int slot;
+
+	/** declared names of the handler interned in the table's dictionary */
+	std::vector< const xmlChar* > names;
+};
+
+/** @class stdXmlDispatchTable
+  * @brief Immutable snapshot of the handlers registered in the stdXmlReader.
+  *
+  * The table indexes the registered handlers by class name and element name.
+  * It is built by the stdXmlReader each time the registered handlers change and
+  * is shared by all stdXmlParseContext's created until the next change, as it is
+  * never modified once built it can be read from any thread without locking.
+  * Handlers are given slots in their registration order.
+  *
+  * The table also owns a dictionary in which the element names and the declared
+  * names of the handlers are interned. Documents parsed by the stdXmlParseContext's
+  * use a dictionary inheriting from it, so that the names of the elements known
+  * by the handlers are the table's own strings : handlers and their members are
+  * then found by comparing pointers.
+  * @author Nicolas Macherey (nm@graymat.fr)
+  * @date 8-May-2010
+  */
+class stdXmlDispatchTable
+{
+public :
+	/** Build the table for the given registrations
+	  * @param handlers registrations in their registration order
+	  */
+	stdXmlDispatchTable( const std::vector< stdXmlHandlerRegistration >& handlers );
+
+	/** Destructor */
+	~stdXmlDispatchTable();
+
+	/** Get the number of handlers in the table */
+	unsigned int GetCount() const {return m_entries.size();};
+
+	/** Get the registration of the handler in the given slot */
+	const stdXmlHandlerRegistration& GetRegistration( unsigned int slot ) const {return m_entries[slot]->registration;};
+
+	/** Find the handler declaring the given class name
+	  * @return the handler's slot or stdNOT_FOUND
+	  */
+	int FindClass( const char* className ) const;
+
+	/** Find the handler declaring the given element name
+	  * @return the handler's slot or stdNOT_FOUND
+	  */
+	int FindNode( const char* nodeName ) const;
+
+	/** Get the slots of the handlers which did not declare their names and which
+	  * can only be found using CanHandle
+	  */
+	const std::vector< unsigned int >& GetUnindexed() const {return m_unindexed;};
+
+	/** Get the declared names of the handler in the given slot, in the order of
+	  * its registration, interned in the table's dictionary.
+	  */
+	const std::vector< const xmlChar* >& GetNames( unsigned int slot ) const {return m_entries[slot]->names;};
+
+	/** Find the handler declaring the given element name interned in the table's
+	  * dictionary, names which are not the table's own strings are not found.
+	  * @return the handler's slot or stdNOT_FOUND
+	  */
+	int FindInterned( const xmlChar* nodeName ) const;
+
+	/** Create a new dictionary inheriting the table's names, the caller has to
+	  * free it using xmlDictFree.
+	  */
+	xmlDict* CreateDict() const {return xmlDictCreateSub( m_dict );};
+
+	/** Check if the given dictionary has been created by CreateDict */
+	bool IsInherited( xmlDict* dict ) const;
+
+private :
+	/** tables cannot be copied */
+	stdXmlDispatchTable( const stdXmlDispatchTable& );
+	stdXmlDispatchTable& operator=( const stdXmlDispatchTable& );
+
+	/** entries by slot */
+	std::vector< stdXmlHandlerEntry* > m_entries;
+
+	/** index of entries by class name */
+	stdHashTable* m_classIndex;
+
+	/** index of entries by element name */
+	stdHashTable* m_nodeIndex;
+
+	/** slots of handlers without declared names */
+	std::vector< unsigned int > m_unindexed;
+
+	/** dictionary of the declared names, never modified once the table is built */
+	xmlDict* m_dict;
+
+	/** index of entries by element names interned in m_dict */
+	stdHashTable* m_internedIndex;
+
+	/** interned string used for recognizing the dictionaries inheriting m_dict */
+	const xmlChar* m_probe;
+};
+
+/** define a shared pointer on a stdXmlDispatchTable */
+typedef boost::shared_ptr< const stdXmlDispatchTable > stdXmlDispatchTablePtr;
+
 /** @class stdXmlReader
   * @brief Main class for reading an xml file in wxg and in generated files
+  *
+  * The stdXmlReader is the registry of the stdXmlHandler's, registering and
+  * unregistering handlers can be done from any thread.
+  * Documents are read and written by stdXmlParseContext's which keep all the
+  * state related to a document and their own instances of the handlers, the
+  * loading and saving methods of the stdXmlReader use a new context for each call
+  * so they can be called from several threads at once. Use a stdXmlParseContext
+  * directly in order to keep the handlers instances between several documents.
   * @author Nicolas Macherey (nm@graymat.fr)
   * @date 8-May-2010
   */
 class stdXmlReader : public stdSingleton<stdXmlReader>
 {
 	friend class stdSingleton<stdXmlReader>;
-	friend class stdXmlHandler;
 
 public :
 	/*******************************************************************************
@@ -114,12 +281,23 @@ public :
 	  * @param description handler's description
 	  * @param ctor handler constructor function pointer
 	  * @param dtor handler destructor function pointer
+	  * @param className name of the class the handler creates and writes. 
+	  * @param nodeName name of the element the handler reads.
+	  * When className and nodeName are given, the handler is found through a hash
+	  * index instead of asking every handler with CanHandle, the handler's CanHandle
+	  * methods shall then accept exactly these names.
+	  * @param names NULL terminated list of the element and attribute names the
+	  * handler reads, see stdXmlHandler::IsName. The list shall outlive the
+	  * registration.
 	  * @return false if the handler already exists in this factory !
 	  */
 	bool RegisterXmlHandler( const std::string& name,
 			const std::string& description,
 			stdXmlHandlerConstructor ctor,
-			stdXmlHandlerDestructor dtor );
+			stdXmlHandlerDestructor dtor,
+			const std::string& className = stdEmptyString,
+			const std::string& nodeName = stdEmptyString,
+			const char* const* names = NULL );
 
 	/** Unregister indicator from that factory,
 	  * Once you have call this method the handler will not be available
@@ -131,8 +309,6 @@ public :
 	  * You can call this method at any time if you want to create a handler
 	  * from it's name only.
 	  * @param name handlers name
-	  * @param g wxg on which the handler will work
-	  * @param interpreter wxgInterpreter interpreter for generating the code
 	  * @return the requested handler instance if exists NULL if it is not existing
 	  */
 	stdXmlHandler* CreateXmlHandler( const std::string& name );
@@ -155,6 +331,50 @@ public :
 	  */
 	void RemoveHandlersOfClass( const std::string& classInfo );
 
+	/** Set the default parallel loading options of the new stdXmlParseContext's,
+	  * see stdXmlParseContext::SetParallelism. Parallel loading is disabled by
+	  * default.
+	  * @param threads number of threads converting the subtrees, 0 for one per core
+	  * and 1 for disabling parallel loading
+	  * @param threshold minimal number of sibling elements for converting them
+	  * in parallel
+	  */
+	void SetParallelism( unsigned int threads , unsigned int threshold = stdXML_PARALLEL_THRESHOLD );
+
+	/** Get the default parallel loading options, see SetParallelism */
+	void GetParallelism( unsigned int& threads , unsigned int& threshold );
+
+	/** Set the default libxml2 parser options of the new stdXmlParseContext's and
+	  * of the record readers, see stdXmlParseContext::SetParseOptions.
+	  * @param options combination of xmlParserOption, stdXML_PARSE_DEFAULT by default
+	  */
+	void SetParseOptions( int options );
+
+	/** Get the default libxml2 parser options, see SetParseOptions */
+	int GetParseOptions();
+
+	/** Enable or disable lazy loading by default in the new stdXmlParseContext's,
+	  * see stdXmlParseContext::SetLazy. Disabled by default.
+	  */
+	void SetLazy( bool lazy );
+
+	/** Check if lazy loading is enabled by default, see SetLazy */
+	bool IsLazy();
+
+	/** Enable or disable fragment caching by default in the new stdXmlParseContext's,
+	  * see stdXmlParseContext::SetFragmentCaching. Disabled by default.
+	  */
+	void SetFragmentCaching( bool caching );
+
+	/** Check if fragment caching is enabled by default, see SetFragmentCaching */
+	bool IsFragmentCaching();
+
+	/** Get the current dispatch table of the registered handlers.
+	  * The table is rebuilt on the first call following a change of the
+	  * registered handlers.
+	  */
+	stdXmlDispatchTablePtr GetDispatchTable();
+
 	/** This is the main stuff of that manager. when you need to read an xml file
 	  * using wxgxmlReader, you shall always use this method.
 	  * It is taking in input the xml file path to read and returns a stdObject
@@ -167,6 +387,42 @@ public :
      * This is the main stuff if you want to load xml from a string
      */
     stdObject* Load( const std::string& data );
+
+	/** Load the given xml file in streaming mode.
+	  * Unlike LoadFile, no DOM tree is built for the document : the file is read
+	  * through an xmlTextReader and each handler fills its object directly from
+	  * the stream (see stdXmlHandler::DoCreateResourceFromStream). Memory usage
+	  * only depends on the depth of the document and not on its size.
+	  * The stdObject returned corresponds to the root node of your xml file.
+	  */
+	stdObject* LoadFileStreaming( const std::string& file );
+
+	/** Load xml from a string in streaming mode, see LoadFileStreaming */
+	stdObject* LoadStreaming( const std::string& data );
+
+	/** Open the given xml file for reading the children of its root node one
+	  * at a time, see stdXmlRecordReader.
+	  * @param file xml file to read
+	  * @return the record reader, you have to delete it once done
+	  */
+	stdXmlRecordReader* OpenRecordsFile( const std::string& file );
+
+	/** Open the given xml string for reading the children of its root node
+	  * one at a time, see stdXmlRecordReader.
+	  * @param data xml to read, it is copied in the record reader
+	  * @return the record reader, you have to delete it once done
+	  */
+	stdXmlRecordReader* OpenRecords( const std::string& data );
+
+	/** Create a parser for reading a document given piece by piece, see
+	  * stdXmlPushParser.
+	  * @param records true for reading the children of the root node as records
+	  * while the document is received, false for reading the whole document
+	  * @param className class name of the records to create, if empty the handler
+	  * is found from the record node
+	  * @return the push parser, you have to delete it once done
+	  */
+	stdXmlPushParser* OpenPush( bool records = false , const std::string& className = stdEmptyString );
 	
 	/** Save the resource in the given file 
 	 * @param file file in which the resource shall be saved 
@@ -179,25 +435,35 @@ public :
      */
     std::string StringSerialize( stdObject* resource );
 
-	/** This is a convenience function made for helping stdXmlHandler's to
-	  * load resource from children of theirs but which they cannot handle.
+	/** Write the resource as a whole document in the given writer.
+	  * No DOM tree is built : each handler writes its object directly in the
+	  * writer (see stdXmlHandler::DoWriteResourceToStream). SaveFile and
+	  * StringSerialize work this way.
+	  * @param writer writer receiving the document
+	  * @param resource resource to write as the document root
 	  */
-	stdObject *CreateResFromNode(xmlNode *node , const std::string& className, stdObject *resource = NULL, stdXmlHandler* handlerToUse = NULL)
-	{
-		return node ? DoCreateResFromNode(node , className , resource, handlerToUse)
-			: NULL;
-	}
+	void Save( stdXmlWriter& writer , stdObject* resource );
 
+	/** This is a convenience function made for loading a resource from a node
+	  * outside of any parse context. stdXmlHandler's shall use their own
+	  * CreateResFromNode method which works in their context.
+	  */
+	stdObject *CreateResFromNode(xmlNode *node , const std::string& className, stdObject *resource = NULL, stdXmlHandler* handlerToUse = NULL);
+
+	/** Same as CreateResFromNode but for the element the given reader is
+	  * positioned on. When this method returns, the reader is either left on
+	  * the element itself or on its end tag so that xmlTextReaderNext moves to
+	  * the next sibling.
+	  */
+	stdObject *CreateResFromStream(xmlTextReaderPtr reader , const std::string& className, stdObject *resource = NULL, stdXmlHandler* handlerToUse = NULL);
 
 	/** Check if the given xmlNode can be handled or not */
 	bool HasHandlerFor( xmlNode* node );
 
-	/** This method is used to write resource to into a node */
-	xmlNode* WriteResource( stdObject* resource, const char* nodename = NULL , stdXmlHandler* handlerToUse = NULL )
-	{
-		return resource ? DoWriteResource(resource, nodename, handlerToUse)
-			: NULL;
-	}
+	/** This method is used to write resource to into a node outside of any parse
+	  * context, stdXmlHandler's shall use their WriteResToNode method instead.
+	  */
+	xmlNode* WriteResource( stdObject* resource, const char* nodename = NULL , stdXmlHandler* handlerToUse = NULL );
 
 
 private :
@@ -218,26 +484,38 @@ private :
 	  */
 	~stdXmlReader();
 
-	/** Creates a stdObject from a node */
-	stdObject *DoCreateResFromNode(xmlNode* node,
-				  const std::string& className,
-                                  stdObject *resource,
-                                  stdXmlHandler *handlerToUse = NULL);
-
-	/** This method is used to write resource to into a node */
-	xmlNode* DoWriteResource( stdObject* resource, const char* nodename = NULL , stdXmlHandler* handlerToUse = NULL );
+	/** Get the name of the class of the handlers created by the given registration */
+	static std::string DoGetHandlerClass( const stdXmlHandlerRegistration& info );
 
 	/** container of all registered handlers */
 	stdXmlHandlerRegistrationMap m_registeredHandlers;
 	
-	/** container of all allocated handlers */
-	stdArrayXmlHandler m_handlers;
+	/** names of the handlers available for reading and writing in their 
+	  * registration order, handlers removed using RemoveHandlersOfClass
+	  * are registered but not listed here.
+	  */
+	std::vector< std::string > m_handlers;
+
+	/** dispatch table of the handlers, NULL when it has to be rebuilt */
+	stdXmlDispatchTablePtr m_table;
+
+	/** default number of threads of the parse contexts */
+	unsigned int m_threads;
 
-	/** XML document */
-	xmlDoc* m_doc;
+	/** default parallel loading threshold of the parse contexts */
+	unsigned int m_threshold;
 
-	/** XML root node */
-	xmlNode* m_root;
+	/** default parser options of the parse contexts */
+	int m_options;
+
+	/** true for loading documents lazily by default */
+	bool m_lazy;
+
+	/** true for keeping the bytes written for the objects by default */
+	bool m_caching;
+
+	/** mutex protecting the registry */
+	boost::mutex m_mutex;
 };
 
 /**
@@ -251,8 +529,9 @@ class stdXmlHandler : public stdObject
 {
 	DECLARE_ABSTRACT_CLASS_STD(stdXmlHandler)
 	
-	/** give stdXmlReader our private members access */
+	/** give stdXmlReader and stdXmlParseContext our private members access */
 	friend class stdXmlReader;
+	friend class stdXmlParseContext;
 
 public :
 	/** Default constructor */
@@ -274,6 +553,13 @@ public :
 	  */
     	stdObject *CreateResource(xmlNode *node, const std::string& className, stdObject *instance);
 
+	/** Creates the resource from the element the given reader is positioned on.
+	  * This is the streaming counterpart of CreateResource, m_node is set to
+	  * the reader's current node so that attributes can be read as usual and
+	  * m_reader is set to the reader.
+	  */
+	stdObject *CreateResourceFromStream(xmlTextReaderPtr reader, const std::string& className, stdObject *instance);
+
 	/** Write the given resource in the given parent node
 	  * This method is used to write an xml document using the
 	  * stdXmlReader system.
@@ -284,6 +570,12 @@ public :
 	  */
 	xmlNode* WriteResource( stdObject* resource, const char* nodename = NULL );
 
+	/** Write the given resource in the given writer.
+	  * This is the streaming counterpart of WriteResource, m_writer is set to
+	  * the writer during the call.
+	  */
+	void WriteResourceToStream( stdObject* resource, stdXmlWriter* writer, const char* nodename = NULL );
+
     	/** This one is called from CreateResource after variables
     	  * were filled.
 	  * Any handlers shall overload this metohd in order to complete the 
@@ -291,11 +583,27 @@ public :
 	  */
     	virtual stdObject *DoCreateResource() = 0;
 
+	/** This one is called from CreateResourceFromStream after variables
+	  * were filled.
+	  * Handlers shall overload this method in order to read their children
+	  * directly from m_reader. The default implementation expands the current
+	  * element into a DOM subtree and calls DoCreateResource.
+	  */
+	virtual stdObject *DoCreateResourceFromStream();
+
 	/** This is the method you have to overload to write a resource
 	  * to anode simply create a new node and write info in
 	  */
 	virtual xmlNode* DoWriteResource() = 0;
 
+	/** This one is called from WriteResourceToStream after variables were
+	  * filled.
+	  * Handlers shall overload this method in order to write their resource
+	  * directly in m_writer. The default implementation writes the node built by
+	  * DoWriteResource.
+	  */
+	virtual void DoWriteResourceToStream();
+
     	/** @return Returns true if it understands this node and can create
     	  * a resource from it, false otherwise.
 	  */
@@ -311,12 +619,67 @@ public :
 	  */
 	virtual bool CanHandle( stdObject* resource ) = 0;
 
+	/** Get the parse context the handler works in, NULL if the handler
+	  * has not been created by a stdXmlParseContext.
+	  */
+	stdXmlParseContext* GetContext() {return m_context;};
+
+protected:
+	/** Check if the given element or attribute name of the current node is the
+	  * declared name in the given index of the handler's registration.
+	  * When the document has been parsed by the handler's context, names are
+	  * interned in the dispatch table's dictionary and are simply compared by
+	  * pointer, otherwise their content is compared.
+	  * @param name name to check
+	  * @param index index of the expected name in the registered names
+	  * @param value the expected name
+	  */
+	bool IsName( const char* name , unsigned int index , const char* value ) const
+	{
+		if( m_interned )
+			return (const xmlChar*) name == (*m_names)[index];
+
+		return strcmp( name , value ) == 0;
+	};
+
+	/** Check if the given child element of the current node has to be read,
+	  * see stdXmlParseContext::SetProjection
+	  */
+	bool AcceptsChild( const char* name ) const
+	{
+		return m_projection == NULL || m_projection->FindChild( name ) != NULL;
+	};
+
+	/** Check if the given attribute of the current node has to be read, see
+	  * stdXmlParseContext::SetProjection
+	  */
+	bool AcceptsAttribute( const char* name ) const
+	{
+		return m_projection == NULL || m_projection->HasAttribute( name );
+	};
+
 protected:
     	// Variables (filled by CreateResource)
     	xmlNode *m_node;
     	std::string m_class;
         std::string m_nodename;
     	stdObject *m_instance;
+	xmlTextReaderPtr m_reader;
+	stdXmlWriter* m_writer;
+
+	/** context the handler has been created by */
+	stdXmlParseContext* m_context;
+
+	/** registered names interned in the dispatch table, NULL if the handler has
+	  * not been created by a stdXmlParseContext.
+	  */
+	const std::vector< const xmlChar* >* m_names;
+
+	/** true when the names of m_node are interned in the dispatch table */
+	bool m_interned;
+
+	/** projection of m_node, NULL when it is read entirely */
+	const stdXmlProjection* m_projection;
 
 protected:
 	/** Creates children. */
@@ -325,11 +688,115 @@ protected:
 	/** Helper function. */
 	void CreateChildrenPrivately(xmlNode *rootnode = NULL);
 
-	/** Creates a resource from a node. */
+	/** Creates a resource from a node in the handler's context. */
 	stdObject *CreateResFromNode(xmlNode *node,
 			const std::string& className,
-			stdObject *instance = NULL)
-	{ return stdXmlReader::Get()->CreateResFromNode(node, className, instance); }		
+			stdObject *instance = NULL);
+
+	/** Creates a resource from the element the reader is positioned on in the
+	  * handler's context. */
+	stdObject *CreateResFromNode(xmlTextReaderPtr reader,
+			const std::string& className,
+			stdObject *instance = NULL);
+
+	/** Defer the loading of an object member when the document is loaded lazily,
+	  * see stdXmlLazyMembers.
+	  * @param node element of the member
+	  * @param className class name of the member, it shall be a static string
+	  * @param members deferred members of the object the member belongs to
+	  * @return false if the document is not loaded lazily, the member has then
+	  * to be created right away
+	  */
+	bool DeferResFromNode( xmlNode* node , const char* className , stdXmlLazyMembers& members );
+
+	/** Documents read in streaming mode are not kept, members cannot be deferred */
+	bool DeferResFromNode( xmlTextReaderPtr , const char* , stdXmlLazyMembers& ) {return false;};
+
+	/** Defer the loading of an array member when the document is loaded lazily,
+	  * the array is loaded from all the elements having the name of the given one,
+	  * see DeferResFromNode
+	  */
+	bool DeferResFromRun( xmlNode* node , const char* className , stdXmlLazyMembers& members );
+
+	/** Documents read in streaming mode are not kept, members cannot be deferred */
+	bool DeferResFromRun( xmlTextReaderPtr , const char* , stdXmlLazyMembers& ) {return false;};
+
+	/** Writes a resource into a node in the handler's context. */
+	xmlNode* WriteResToNode( stdObject* resource, const char* nodename = NULL );
+
+	/** Writes a resource as a child of the given node in the handler's context. */
+	void WriteResToParent( xmlNode* node, stdObject* resource, const char* nodename = NULL );
+
+	/** Writes a resource in the given writer in the handler's context. */
+	void WriteResToParent( stdXmlWriter* writer, stdObject* resource, const char* nodename = NULL );
+
+	/** Creates the resources of the run of sibling elements starting at the given
+	  * node and having its name, and appends them to items.
+	  * Elements of large runs are converted in parallel when the handler's context
+	  * allows it (see stdXmlParseContext::SetParallelism), items are always
+	  * appended in the document order. Elements for which no resource can be
+	  * created are skipped.
+	  * @param node [in,out] first element of the run, set to the last one on return
+	  * @param className class name of the resources to create
+	  * @param items array receiving the resources
+	  * @return true if at least one resource has been created
+	  */
+	template< class T > bool CreateResFromRun( xmlNode*& node , const std::string& className , std::vector< T >& items )
+	{
+		const xmlChar* name = node->name;
+		std::vector< xmlNode* > nodes;
+
+		for( xmlNode* sibling = node ; sibling != NULL ; sibling = sibling->next ) {
+			if( sibling->type != XML_ELEMENT_NODE )
+				continue;
+
+			if( !xmlStrEqual( sibling->name , name ) )
+				break;
+
+			nodes.push_back( sibling );
+		}
+
+		node = nodes.back();
+
+		size_t base = items.size();
+		items.resize( base + nodes.size() );
+
+		std::vector< stdObject* > instances( nodes.size() );
+		std::vector< stdObject* > results;
+
+		for( size_t i = 0; i < nodes.size() ; ++i )
+			instances[i] = &items[base + i];
+
+		DoCreateResFromNodes( nodes , className , instances , results );
+
+		return stdXmlKeepCreated( items , base , results );
+	}
+
+	/** Same as CreateResFromRun for the element the given reader is positioned on,
+	  * readers cannot look ahead so only this element is read.
+	  */
+	template< class T > bool CreateResFromRun( xmlTextReaderPtr reader , const std::string& className , std::vector< T >& items )
+	{
+		items.push_back( T() );
+
+		if( CreateResFromNode( reader , className , &items.back() ) != NULL )
+			return true;
+
+		items.pop_back();
+		return false;
+	}
+
+private :
+	/** Get the projection of the given child element of m_node, NULL when it
+	  * is read entirely
+	  */
+	const stdXmlProjection* DoGetChildProjection( const xmlChar* name ) const;
+
+	/** Creates the resources of the given nodes in the given instances using
+	  * the handler's context, see stdXmlParseContext::CreateResFromNodes
+	  */
+	void DoCreateResFromNodes( const std::vector< xmlNode* >& nodes , const std::string& className ,
+			const std::vector< stdObject* >& instances , std::vector< stdObject* >& results );
 };
 
 /** define a macro for helping creating the instance inside a wxXmlHandler :D */
@@ -340,6 +807,16 @@ protected:
    if (!variable) \
        variable = new classname;
 
+/** same as stdMAKE_INSTANCE, the instance is taken from the pool of the class
+  * when it is enabled, see stdObjectPool
+  */
+#define stdMAKE_POOLED_INSTANCE(variable, classname) \
+   classname *variable = NULL; \
+   if (m_instance) \
+       variable = static_cast<classname*>(m_instance); \
+   if (!variable) \
+       variable = stdObjectPool< classname >::Acquire();
+
 /**
   * @class stdXmlHandlerRegistrant
   * @brief this main template allows you to register easily your stdXmlHandler in the stdXmlReader
@@ -355,6 +832,17 @@ protected:
   * @code
   * stdREGISTER_XMLHANDLER( MyXmlHandler , "Description of my XmlHandler" );
   * @endcode
+  * If your handler creates a single class from a single element name, declare them
+  * so that stdXmlReader can find your handler without calling CanHandle :
+  * @code
+  * stdREGISTER_XMLHANDLER_FOR( MyXmlHandler , "Description of my XmlHandler" , "MyClass" , "myelement" );
+  * @endcode
+  * Handlers comparing element and attribute names using stdXmlHandler::IsName
+  * declare these names as well :
+  * @code
+  * static const char* const MyXmlHandlerNames[] = { "name" , "value" , NULL };
+  * stdREGISTER_XMLHANDLER_NAMES( MyXmlHandler , "Description of my XmlHandler" , "MyClass" , "myelement" , MyXmlHandlerNames );
+  * @endcode
   *
   * @author Nicolas Macherey (nm@graymat.fr)
   * @date 8-May-2010
@@ -363,12 +851,14 @@ template<class T> class stdXmlHandlerRegistrant
 {
 
 public :
-	stdXmlHandlerRegistrant( const std::string& name , const std::string& description ):
+	stdXmlHandlerRegistrant( const std::string& name , const std::string& description ,
+		const std::string& className = stdEmptyString , const std::string& nodeName = stdEmptyString ,
+		const char* const* names = NULL ):
 		m_name(name)
 	{
 		/* The main task is to call the stdXmlReader and to register the handler in 
 		 * using our two satic method that will be used to register in the factory */
-		stdXmlReader::Get()->RegisterXmlHandler( name , description , &Create , &Free );
+		stdXmlReader::Get()->RegisterXmlHandler( name , description , &Create , &Free , className , nodeName , names );
 	}
 	
 	~stdXmlHandlerRegistrant()
@@ -404,5 +894,15 @@ private :
 		stdXmlHandlerRegistrant<object> registrant( #object , description ); \
 	};
 
+#define stdREGISTER_XMLHANDLER_FOR( object , description , className , nodeName ) \
+	namespace ns##object { \
+		stdXmlHandlerRegistrant<object> registrant( #object , description , className , nodeName ); \
+	};
+
+#define stdREGISTER_XMLHANDLER_NAMES( object , description , className , nodeName , names ) \
+	namespace ns##object { \
+		stdXmlHandlerRegistrant<object> registrant( #object , description , className , nodeName , names ); \
+	};
+
 #endif
 		
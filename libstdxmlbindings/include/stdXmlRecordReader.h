@@ -0,0 +1,170 @@
+/**
+ * @file stdXmlRecordReader.h
+ * @brief main file for reading the records of an xml file one at a time
+ * @author Nicolas Macherey (nm@graymat.fr)
+ * @version 10.4
+ */
+#ifndef STD_XMLRECORDREADER_H
+#define STD_XMLRECORDREADER_H
+
+#include <iterator>
+#include <cstddef>
+
+#include "stdXmlReader.h"
+#include "stdXmlParseContext.h"
+
+/** @class stdXmlRecordReader
+  * @brief Pull reader over the children of the root element of a document
+  *
+  * Large documents are often made of a huge list of sibling records below the root
+  * node. The stdXmlRecordReader reads such documents in streaming mode and
+  * materializes these records one at a time using the registered stdXmlHandler's,
+  * so that only one of them has to exist in memory at once.
+  *
+  * Records returned by Next are owned by the stdXmlRecordReader and are deleted
+  * on the next call to Next or when the reader is destroyed, unless you take their
+  * ownership using Release.
+  *
+  * @code
+  * stdXmlRecordReader* records = stdXmlReader::Get()->OpenRecordsFile( "holidays.xml" );
+  * while( stdObject* record = records->Next() ) {
+  *	// process record
+  * }
+  * delete records;
+  * @endcode
+  *
+  * @author Nicolas Macherey (nm@graymat.fr)
+  * @date 8-May-2010
+  */
+class stdXmlRecordReader
+{
+	friend class stdXmlReader;
+
+public :
+	/** Destructor, deletes the current record if it was not released and
+	  * closes the document.
+	  */
+	~stdXmlRecordReader();
+
+	/** Read the next record of the document.
+	  * The previous record is deleted unless it has been released. Children of the root
+	  * node for which no handler can be found are skipped.
+	  * @param className class name of the record to create, if empty the handler is
+	  * found from the record node
+	  * @return the next record or NULL if the end of the root node has been reached
+	  */
+	stdObject* Next( const std::string& className = stdEmptyString );
+
+	/** Get the record read by the last call to Next */
+	stdObject* GetCurrent() {return m_current;};
+
+	/** Take the ownership of the current record, it will no longer be deleted
+	  * by the stdXmlRecordReader.
+	  */
+	stdObject* Release();
+
+	/** Get the name of the document root node */
+	const std::string& GetRootName() const {return m_rootName;};
+
+private :
+	/** Constructor, only stdXmlReader can build record readers
+	  * @param reader reader to read the records from
+	  * @param data buffer the reader is working on if any, it has to live as
+	  * long as the reader.
+	  */
+	stdXmlRecordReader( xmlTextReaderPtr reader , const std::string& data = stdEmptyString );
+
+	/** Move the reader to the document root */
+	void DoReadRoot();
+
+	/** reader used to read the document */
+	xmlTextReaderPtr m_reader;
+
+	/** copy of the document for readers working in memory */
+	std::string m_data;
+
+	/** document root node name */
+	std::string m_rootName;
+
+	/** context the records are created in */
+	stdXmlParseContext m_context;
+
+	/** current record */
+	stdObject* m_current;
+
+	/** true once the reader is positionned on the root node */
+	bool m_started;
+
+	/** true once the end of the root node has been reached */
+	bool m_finished;
+};
+
+/** @class stdXmlRecordIterator
+  * @brief Input iterator over the records of a stdXmlRecordReader having the given type.
+  *
+  * Records which are not of type T are skipped, the default constructed iterator
+  * is the end iterator.
+  * @code
+  * stdXmlRecordReader* records = stdXmlReader::Get()->OpenRecordsFile( "holidays.xml" );
+  * stdXmlRecordIterator<PersonHolidaysType> it( records ), end;
+  * for( ; it != end ; ++it )
+  *	std::cout << it->GetPerson().GetFirstname() << std::endl;
+  * delete records;
+  * @endcode
+  *
+  * @author Nicolas Macherey (nm@graymat.fr)
+  * @date 8-May-2010
+  */
+template< class T > class stdXmlRecordIterator
+{
+public :
+	typedef std::input_iterator_tag iterator_category;
+	typedef T value_type;
+	typedef std::ptrdiff_t difference_type;
+	typedef T* pointer;
+	typedef T& reference;
+
+	/** End iterator constructor */
+	stdXmlRecordIterator():
+		m_records(NULL),
+		m_current(NULL)
+	{};
+
+	/** Constructor, reads the first record of type T from the given reader */
+	stdXmlRecordIterator( stdXmlRecordReader* records , const std::string& className = stdEmptyString ):
+		m_records(records),
+		m_className(className),
+		m_current(NULL)
+	{
+		DoNext();
+	};
+
+	/** Move to the next record of type T */
+	stdXmlRecordIterator& operator++() {DoNext();return (*this);};
+
+	T& operator*() const {return *m_current;};
+	T* operator->() const {return m_current;};
+
+	bool operator==( const stdXmlRecordIterator& rhs ) const {return m_current == rhs.m_current;};
+	bool operator!=( const stdXmlRecordIterator& rhs ) const {return m_current != rhs.m_current;};
+
+private :
+	void DoNext()
+	{
+		m_current = NULL;
+
+		if( m_records == NULL )
+			return;
+
+		stdObject* record = m_records->Next( m_className );
+
+		while( record != NULL && (m_current = dynamic_cast<T*>(record)) == NULL )
+			record = m_records->Next( m_className );
+	};
+
+	stdXmlRecordReader* m_records;
+	std::string m_className;
+	T* m_current;
+};
+
+#endif
@@ -0,0 +1,298 @@
+/**
+ * @file stdXmlWriter.h
+ * @brief main file for writing xml documents without building them in memory
+ * @author Nicolas Macherey (nm@graymat.fr)
+ * @version 10.4
+ */
+#ifndef STD_XMLWRITER_H
+#define STD_XMLWRITER_H
+
+#include <string>
+#include <cstring>
+#include <vector>
+#include <iosfwd>
+
+#include <libxml/tree.h>
+
+#include "stdXmlFragment.h"
+
+/** size of the buffer of writers working on streams, it is flushed to the
+  * stream each time it is full.
+  */
+#define stdXML_WRITER_BUFFER_SIZE 65536
+
+/** @class stdXmlWriter
+  * @brief Buffered writer producing xml documents directly into their output.
+  *
+  * The writer produces the same bytes as libxml2 does when saving a document
+  * built with xmlNewNode, xmlNewProp and xmlNewTextChild : same escaping, same
+  * empty elements and, when formatting, same indentation. Elements containing
+  * text are not indented, as libxml2 does, the text shall then be written before
+  * any child element.
+  *
+  * Without encoding the document has no encoding declaration and non ASCII
+  * characters are written as character references, like xmlDocDumpMemory does.
+  * With the "UTF-8" encoding they are written as they are, like
+  * xmlSaveFormatFileEnc does.
+  *
+  * @code
+  * std::string data;
+  * stdXmlWriter writer( data );
+  * writer.StartDocument();
+  * writer.StartElement( "person" );
+  * writer.WriteAttribute( "name" , "Toto" );
+  * writer.WriteElement( "city" , "Toto City" );
+  * writer.EndElement();
+  * writer.EndDocument();
+  * @endcode
+  *
+  * With fragment caching enabled, the bytes of the elements started with a
+  * stdXmlFragment are kept in it when they are closed, and WriteFragment writes
+  * them again instead of the element. The output is not flushed to the stream
+  * while such an element is open.
+  *
+  * @author Nicolas Macherey (nm@graymat.fr)
+  * @date 8-May-2010
+  */
+class stdXmlWriter
+{
+public :
+	/** Constructor, writes the document at the end of the given string
+	  * @param output string receiving the document, it shall outlive the writer
+	  * @param format true for indenting the elements
+	  * @param encoding NULL or "UTF-8"
+	  */
+	stdXmlWriter( std::string& output , bool format = false , const char* encoding = NULL );
+
+	/** Constructor, writes the document in the given stream
+	  * @param output stream receiving the document, it shall outlive the writer
+	  * @param format true for indenting the elements
+	  * @param encoding NULL or "UTF-8"
+	  */
+	stdXmlWriter( std::ostream& output , bool format = false , const char* encoding = NULL );
+
+	/** Constructor, writes the document in the given file
+	  * @param file name of the file to create
+	  * @param format true for indenting the elements
+	  * @param encoding NULL or "UTF-8"
+	  */
+	stdXmlWriter( const char* file , bool format = false , const char* encoding = NULL );
+
+	/** Destructor, flushes the buffer */
+	~stdXmlWriter();
+
+	/** Write the xml declaration */
+	void StartDocument();
+
+	/** Close all open elements and flush the buffer */
+	void EndDocument();
+
+	/** Open a new element in the current one
+	  * @param name element name
+	  * @param fragment fragment receiving the bytes of the element when it is
+	  * closed if fragment caching is enabled, NULL for not keeping them
+	  */
+	void StartElement( const char* name , const stdXmlFragment* fragment = NULL );
+
+	/** Write the bytes kept in the given fragment as a new element in the current
+	  * one, if they have been written with the same name at the same position in
+	  * the indentation and with the same encoding
+	  * @return false if fragment caching is disabled or if the element shall be
+	  * written again
+	  */
+	bool WriteFragment( const stdXmlFragment& fragment , const char* name );
+
+	/** Do not keep the bytes of the open elements, this is called before writing
+	  * content which their objects do not track */
+	void DiscardFragments() {m_captures.clear();};
+
+	/** Write an attribute of the element just opened, before its content
+	  * @param name attribute name
+	  * @param value attribute value, it is escaped
+	  */
+	void WriteAttribute( const char* name , const char* value );
+
+	/** Write text in the current element, it is escaped */
+	void WriteString( const char* text );
+
+	/** Close the current element */
+	void EndElement();
+
+	/** Write an element containing the given text, the element is empty if the
+	  * text is empty. This is the same as xmlNewTextChild.
+	  */
+	void WriteElement( const char* name , const char* text );
+
+	/** Write the given node and its subtree */
+	void WriteNode( xmlNode* node );
+
+	/** Write the buffer in the output stream, the buffer is kept while elements
+	  * whose bytes are kept in a fragment are open */
+	void Flush();
+
+	/** Get the depth of the current element, 0 when there is no open element */
+	unsigned int GetDepth() const {return m_names.size();};
+
+	/** Enable or disable fragment caching, see stdXmlFragment. Disabled by default. */
+	void SetFragmentCaching( bool caching ) {m_caching = caching;};
+
+	/** Check if fragment caching is enabled, see SetFragmentCaching */
+	bool IsFragmentCaching() const {return m_caching;};
+
+private :
+	/** writers cannot be copied */
+	stdXmlWriter( const stdXmlWriter& );
+	stdXmlWriter& operator=( const stdXmlWriter& );
+
+	/** Set the encoding of the document, throws if it is not supported */
+	void DoSetEncoding( const char* encoding );
+
+	/** Append raw bytes to the output */
+	void DoWrite( const char* data , size_t length )
+	{
+		m_out->append( data , length );
+
+		if( m_stream != NULL && m_out->size() >= stdXML_WRITER_BUFFER_SIZE )
+			Flush();
+	};
+
+	/** Append a zero terminated string to the output */
+	void DoWrite( const char* data ) {DoWrite( data , strlen( data ) );};
+
+	/** Prepare the output for a new child of the current element : close its
+	  * start tag if it is still open and indent the child.
+	  */
+	void DoStartChild();
+
+	/** Terminate the output of a child of the current element */
+	void DoEndChild();
+
+	/** Write the indentation of the given depth if formatting */
+	void DoIndent( unsigned int depth );
+
+	/** Write the given text escaped
+	  * @param text text to write
+	  * @param attribute true for escaping an attribute value
+	  */
+	void DoWriteEscaped( const char* text , bool attribute );
+
+	/** Check if the current element is indented, elements are not indented
+	  * inside an element containing text.
+	  */
+	bool DoIsFormatted() const {return m_format && m_rawDepth == 0;};
+
+	/** Get the key of the fragments written as children of the current element.
+	  * The bytes of an element only depend on its indentation and on the encoding.
+	  */
+	unsigned int DoFragmentKey() const
+	{
+		unsigned int key = m_utf8 ? 3 : 1;
+
+		if( DoIsFormatted() )
+			key |= ( m_names.size() + 1 ) << 2;
+
+		return key;
+	};
+
+	/** @struct Capture
+	  * @brief Element whose bytes are kept in a fragment when it is closed
+	  */
+	struct Capture
+	{
+		/** fragment receiving the bytes */
+		const stdXmlFragment* fragment;
+
+		/** offset of the start tag in the output */
+		size_t start;
+
+		/** depth of the element */
+		unsigned int depth;
+
+		/** key of the fragment */
+		unsigned int key;
+	};
+
+	/** buffer or string receiving the output */
+	std::string* m_out;
+
+	/** buffer used when writing to a stream */
+	std::string m_buffer;
+
+	/** stream receiving the output, NULL when writing to a string */
+	std::ostream* m_stream;
+
+	/** stream created by the writer */
+	std::ostream* m_file;
+
+	/** true for indenting the elements */
+	bool m_format;
+
+	/** true for writing non ASCII characters as they are */
+	bool m_utf8;
+
+	/** encoding written in the xml declaration */
+	std::string m_encoding;
+
+	/** true if the start tag of the current element is still open */
+	bool m_open;
+
+	/** depth of the element containing text, 0 if there is none */
+	unsigned int m_rawDepth;
+
+	/** names of the open elements, separated by zeros */
+	std::string m_nameBuffer;
+
+	/** offset of the open elements names in m_nameBuffer */
+	std::vector< size_t > m_names;
+
+	/** true for keeping the bytes of the elements in their fragments */
+	bool m_caching;
+
+	/** open elements whose bytes are kept, from the outermost one */
+	std::vector< Capture > m_captures;
+};
+
+/** @name Writing helpers
+  * Helpers used by generated handlers for writing the same content either in
+  * a DOM node or in a stdXmlWriter.
+  */
+/*@{*/
+/** Add an attribute to the given node */
+inline void stdXmlWriteAttr( xmlNode* node , const char* name , const char* value )
+{
+	xmlNewProp( node , (const xmlChar*) name , (const xmlChar*) value );
+}
+
+/** Write an attribute of the element just opened in the writer */
+inline void stdXmlWriteAttr( stdXmlWriter* writer , const char* name , const char* value )
+{
+	writer->WriteAttribute( name , value );
+}
+
+/** Add a child element containing the given text to the given node, the text
+  * is not interpreted and the element is empty if the text is empty.
+  */
+inline void stdXmlWriteChild( xmlNode* node , const char* name , const char* text )
+{
+	xmlNewTextChild( node , NULL , (const xmlChar*) name , *text ? (const xmlChar*) text : NULL );
+}
+
+/** Write an element containing the given text in the writer */
+inline void stdXmlWriteChild( stdXmlWriter* writer , const char* name , const char* text )
+{
+	writer->WriteElement( name , text );
+}
+
+/** Nodes do not keep fragments */
+inline void stdXmlDiscardFragments( xmlNode* )
+{
+}
+
+/** Do not keep the bytes of the elements open in the writer */
+inline void stdXmlDiscardFragments( stdXmlWriter* writer )
+{
+	writer->DiscardFragments();
+}
+/*@}*/
+
+#endif
@@ -0,0 +1,153 @@
+/**
+ * @file stdBinaryDelta.cpp
+ * @brief main file for encoding the differences between two objects in the compact binary format
+ * @author Nicolas Macherey (nm@graymat.fr)
+ * @version 10.4
+ */
+#include <libxml/xmlreader.h>
+#include <libxml/xpath.h>
+
+#include <string>
+
+#include "stdException.h"
+
+#include "stdBinaryDelta.h"
+
+void stdBinaryDeltaWriter::Unset( unsigned int member )
+{
+	m_writer->Write( stdBINARY_DELTA_UNSET , member );
+}
+
+void stdBinaryDeltaWriter::StartChange( unsigned int member )
+{
+	m_start = m_writer->GetOutput().size();
+	m_change = m_writer->StartMessage( stdBINARY_DELTA_CHANGE );
+	m_writer->Write( stdBINARY_CHANGE_MEMBER , member );
+	m_index = 0;
+	m_edits = 0;
+}
+
+void stdBinaryDeltaWriter::EndChange( bool keep )
+{
+	if( m_edits == 0 && !keep ) {
+		m_writer->GetOutput().resize( m_start );
+		return;
+	}
+
+	m_writer->EndMessage( m_change );
+}
+
+stdBinaryWriter& stdBinaryDeltaWriter::StartEdit( unsigned int edit , unsigned int index )
+{
+	m_editStart = m_writer->GetOutput().size();
+	m_previous = m_index;
+	m_kind = edit;
+	DoWriteIndex( index );
+	m_edit = m_writer->StartMessage( edit );
+
+	return *m_writer;
+}
+
+void stdBinaryDeltaWriter::EndEdit()
+{
+	std::string& output = m_writer->GetOutput();
+
+	/* the nested delta is empty, the items are equal */
+	if( output.size() == m_edit ) {
+		output.resize( m_editStart );
+		m_index = m_previous;
+		return;
+	}
+
+	m_writer->EndMessage( m_edit );
+	++m_edits;
+
+	if( m_kind == stdBINARY_CHANGE_UPDATE )
+		++m_index;
+}
+
+void stdBinaryDeltaWriter::Remove( unsigned int index , unsigned int count )
+{
+	if( count == 0 )
+		return;
+
+	DoWriteIndex( index );
+	m_writer->Write( stdBINARY_CHANGE_REMOVE , count );
+	++m_edits;
+}
+
+void stdBinaryDeltaWriter::Close()
+{
+	if( !m_sets.empty() )
+		m_writer->Write( stdBINARY_DELTA_SET , m_sets );
+
+	m_sets.clear();
+}
+
+void stdBinaryDeltaWriter::DoWriteIndex( unsigned int index )
+{
+	if( index == m_index )
+		return;
+
+	m_writer->Write( stdBINARY_CHANGE_INDEX , index );
+	m_index = index;
+}
+
+bool stdBinaryDeltaChange::Read( stdBinaryReader& delta )
+{
+	m_member = 0;
+	m_edit = 0;
+	m_index = 0;
+	m_next = 0;
+	m_count = 0;
+	m_unset = delta.GetField() == stdBINARY_DELTA_UNSET;
+	m_edits = stdBinaryReader();
+
+	if( m_unset )
+		return delta.Read( m_member );
+
+	if( !delta.ReadMessage( m_edits ) )
+		return false;
+
+	/* the member is the first field of the change */
+	if( !m_edits.Next() || m_edits.GetField() != stdBINARY_CHANGE_MEMBER )
+		STD_THROW( "Error malformed delta, a change shall start with its member" );
+
+	return m_edits.Read( m_member );
+}
+
+bool stdBinaryDeltaChange::Next()
+{
+	while( m_edits.Next() ) {
+		switch( m_edits.GetField() )
+		{
+		case stdBINARY_CHANGE_INDEX :
+			m_edits.Read( m_next );
+			break;
+		case stdBINARY_CHANGE_REMOVE :
+			if( m_edits.Read( m_count ) ) {
+				m_edit = stdBINARY_CHANGE_REMOVE;
+				m_index = m_next;
+				return true;
+			}
+			break;
+		case stdBINARY_CHANGE_UPDATE :
+		case stdBINARY_CHANGE_INSERT :
+			if( m_edits.ReadMessage( m_value ) ) {
+				m_edit = m_edits.GetField();
+				m_index = m_next;
+
+				/* updates move to the next item */
+				if( m_edit == stdBINARY_CHANGE_UPDATE )
+					++m_next;
+				return true;
+			}
+			break;
+		default :
+			m_edits.Skip();
+			break;
+		}
+	}
+
+	return false;
+}
@@ -0,0 +1,251 @@
+/**
+ * @file stdBinarySerializer.cpp
+ * @brief main file for serializing objects in the compact binary format
+ * @author Nicolas Macherey (nm@graymat.fr)
+ * @version 10.4
+ */
+#include <string>
+#include <map>
+
+#include "stdException.h"
+
+#include "stdBinarySerializer.h"
+
+/** Global instance for the stdBinarySerializer */
+template<> stdBinarySerializer* stdSingleton<stdBinarySerializer>::instance = 0;
+
+/** Global isShutdown initialization for the stdBinarySerializer */
+template<> bool  stdSingleton<stdBinarySerializer>::isShutdown = false;
+
+stdBinarySerializer::~stdBinarySerializer()
+{
+	std::map< std::string , stdBinaryHandler* >::iterator it = m_handlers.begin();
+
+	for( ; it != m_handlers.end() ; ++it )
+		delete it->second;
+
+	m_handlers.clear();
+}
+
+bool stdBinarySerializer::RegisterHandler( const std::string& className , stdBinaryHandler* handler )
+{
+	boost::mutex::scoped_lock lock( m_mutex );
+
+	if( m_handlers.find( className ) != m_handlers.end() ) {
+		delete handler;
+		return false;
+	}
+
+	m_handlers[className] = handler;
+	return true;
+}
+
+bool stdBinarySerializer::UnregisterHandler( const std::string& className )
+{
+	boost::mutex::scoped_lock lock( m_mutex );
+	std::map< std::string , stdBinaryHandler* >::iterator it = m_handlers.find( className );
+
+	if( it == m_handlers.end() )
+		return false;
+
+	delete it->second;
+	m_handlers.erase( it );
+	return true;
+}
+
+stdBinaryHandler* stdBinarySerializer::FindHandler( const std::string& className )
+{
+	boost::mutex::scoped_lock lock( m_mutex );
+	std::map< std::string , stdBinaryHandler* >::iterator it = m_handlers.find( className );
+
+	return it != m_handlers.end() ? it->second : NULL;
+}
+
+stdBinaryHandler* stdBinarySerializer::FindHandler( stdObject* resource )
+{
+	return FindHandler( std::string( resource->GetClassInfo()->GetClassName() ) );
+}
+
+std::string stdBinarySerializer::Serialize( stdObject* resource )
+{
+	std::string output;
+	Serialize( resource , output );
+	return output;
+}
+
+void stdBinarySerializer::Serialize( stdObject* resource , std::string& output )
+{
+	if( resource == NULL )
+		STD_THROW("Error cannot serialize a NULL resource!");
+
+	stdBinaryWriter writer( output );
+	DoWriteEnvelope( writer , resource );
+}
+
+stdObject* stdBinarySerializer::Load( const std::string& data )
+{
+	return Load( data.data() , data.size() );
+}
+
+stdObject* stdBinarySerializer::Load( const char* data , size_t size )
+{
+	stdBinaryReader reader( data , size );
+	stdObject* resource = ReadObject( reader );
+
+	if( resource == NULL )
+		STD_THROW("Error cannot get your document root !");
+
+	return resource;
+}
+
+void stdBinarySerializer::WriteObject( stdBinaryWriter& writer , unsigned int field , stdObject* resource )
+{
+	size_t mark = writer.StartMessage( field );
+	DoWriteEnvelope( writer , resource );
+	writer.EndMessage( mark );
+}
+
+void stdBinarySerializer::DoWriteEnvelope( stdBinaryWriter& writer , stdObject* resource )
+{
+	std::string className( resource->GetClassInfo()->GetClassName() );
+	stdBinaryHandler* handler = DoGetHandler( className );
+
+	writer.Write( stdBINARY_ENVELOPE_CLASS , className );
+
+	size_t mark = writer.StartMessage( stdBINARY_ENVELOPE_OBJECT );
+	handler->Encode( resource , writer );
+	writer.EndMessage( mark );
+}
+
+stdObject* stdBinarySerializer::ReadObject( stdBinaryReader& reader )
+{
+	stdBinaryHandler* handler = NULL;
+	stdObject* resource = NULL;
+
+	try {
+		while( reader.Next() ) {
+			switch( reader.GetField() )
+			{
+			case stdBINARY_ENVELOPE_CLASS :
+			{
+				std::string className;
+
+				if( resource == NULL && reader.Read( className ) )
+					handler = DoGetHandler( className );
+				break;
+			}
+			case stdBINARY_ENVELOPE_OBJECT :
+			{
+				stdBinaryReader message;
+
+				if( handler != NULL && resource == NULL && reader.ReadMessage( message ) ) {
+					resource = handler->Create();
+					handler->Decode( message , resource );
+				}
+				else
+					reader.Skip();
+				break;
+			}
+			default :
+				reader.Skip();
+				break;
+			}
+		}
+	}
+	catch( ... ) {
+		delete resource;
+		throw;
+	}
+
+	return resource;
+}
+
+std::string stdBinarySerializer::Diff( const stdObject& from , const stdObject& to )
+{
+	std::string output;
+	Diff( from , to , output );
+	return output;
+}
+
+void stdBinarySerializer::Diff( const stdObject& from , const stdObject& to , std::string& output )
+{
+	std::string className( to.GetClassInfo()->GetClassName() );
+
+	if( className != from.GetClassInfo()->GetClassName() )
+		STD_THROW("Error cannot diff objects of different classes " + std::string( from.GetClassInfo()->GetClassName() ) + " and " + className + "!");
+
+	stdBinaryHandler* handler = DoGetHandler( className );
+
+	size_t start = output.size();
+	stdBinaryWriter writer( output );
+	writer.Write( stdBINARY_ENVELOPE_CLASS , className );
+
+	size_t mark = writer.StartMessage( stdBINARY_ENVELOPE_DELTA );
+	handler->Diff( &from , &to , writer );
+
+	/* the objects are equal */
+	if( output.size() == mark ) {
+		output.resize( start );
+		return;
+	}
+
+	writer.EndMessage( mark );
+}
+
+void stdBinarySerializer::Patch( stdObject& resource , const std::string& delta )
+{
+	Patch( resource , delta.data() , delta.size() );
+}
+
+void stdBinarySerializer::Patch( stdObject& resource , const char* data , size_t size )
+{
+	std::string className( resource.GetClassInfo()->GetClassName() );
+	stdBinaryHandler* handler = DoGetHandler( className );
+	stdBinaryReader reader( data , size );
+
+	while( reader.Next() ) {
+		switch( reader.GetField() )
+		{
+		case stdBINARY_ENVELOPE_CLASS :
+		{
+			std::string deltaClass;
+
+			if( reader.Read( deltaClass ) && deltaClass != className )
+				STD_THROW("Error cannot apply a delta of class " + deltaClass + " to an object of class " + className + "!");
+			break;
+		}
+		case stdBINARY_ENVELOPE_DELTA :
+		{
+			stdBinaryReader message;
+
+			if( reader.ReadMessage( message ) )
+				handler->Patch( message , &resource );
+			break;
+		}
+		default :
+			reader.Skip();
+			break;
+		}
+	}
+}
+
+bool stdBinarySerializer::Equals( const stdObject* lhs , const stdObject* rhs )
+{
+	if( lhs == rhs )
+		return true;
+
+	if( lhs == NULL || rhs == NULL )
+		return false;
+
+	return Serialize( const_cast< stdObject* >( lhs ) ) == Serialize( const_cast< stdObject* >( rhs ) );
+}
+
+stdBinaryHandler* stdBinarySerializer::DoGetHandler( const std::string& className )
+{
+	stdBinaryHandler* handler = FindHandler( className );
+
+	if( handler == NULL )
+		STD_THROW("Error no binary handler found for class " + className + "!");
+
+	return handler;
+}
@@ -0,0 +1,308 @@
+/**
+ * @file stdBinaryStream.cpp
+ * @brief main file for encoding and decoding objects in the compact binary format
+ * @author Nicolas Macherey (nm@graymat.fr)
+ * @version 10.4
+ */
+#include <string.h>
+
+#include <string>
+
+#include "stdException.h"
+#include "stdBinaryStream.h"
+
+/** maximal length of a varint */
+#define stdBINARY_VARINT_SIZE 10
+
+/** Encode the given varint in buffer
+  * @return the number of bytes written
+  */
+static int stdBinaryEncodeVarint( char* buffer , unsigned long value )
+{
+	int count = 0;
+
+	while( value >= 0x80 ) {
+		buffer[count++] = (char) ( ( value & 0x7F ) | 0x80 );
+		value >>= 7;
+	}
+
+	buffer[count++] = (char) value;
+	return count;
+}
+
+/** Zigzag encoding of signed values */
+static unsigned long stdBinaryZigZag( long value )
+{
+	return ( (unsigned long) value << 1 ) ^ (unsigned long) ( value < 0 ? -1L : 0L );
+}
+
+/** Zigzag decoding of signed values */
+static long stdBinaryUnZigZag( unsigned long value )
+{
+	return (long) ( value >> 1 ) ^ -(long) ( value & 1 );
+}
+
+void stdBinaryWriter::DoWriteVarint( unsigned long value )
+{
+	char buffer[stdBINARY_VARINT_SIZE];
+	m_out->append( buffer , stdBinaryEncodeVarint( buffer , value ) );
+}
+
+void stdBinaryWriter::DoWriteFixed( boost::uint64_t value , int bytes )
+{
+	char buffer[8];
+
+	for( int i = 0 ; i < bytes ; ++i ) {
+		buffer[i] = (char) ( value & 0xFF );
+		value >>= 8;
+	}
+
+	m_out->append( buffer , bytes );
+}
+
+void stdBinaryWriter::Write( unsigned int field , int value )
+{
+	Write( field , (long) value );
+}
+
+void stdBinaryWriter::Write( unsigned int field , unsigned int value )
+{
+	Write( field , (unsigned long) value );
+}
+
+void stdBinaryWriter::Write( unsigned int field , long value )
+{
+	DoWriteKey( field , stdBINARY_VARINT );
+	DoWriteVarint( stdBinaryZigZag( value ) );
+}
+
+void stdBinaryWriter::Write( unsigned int field , unsigned long value )
+{
+	DoWriteKey( field , stdBINARY_VARINT );
+	DoWriteVarint( value );
+}
+
+void stdBinaryWriter::Write( unsigned int field , bool value )
+{
+	DoWriteKey( field , stdBINARY_VARINT );
+	m_out->push_back( value ? 1 : 0 );
+}
+
+void stdBinaryWriter::Write( unsigned int field , double value )
+{
+	boost::uint64_t bits;
+	memcpy( &bits , &value , sizeof(bits) );
+
+	DoWriteKey( field , stdBINARY_FIXED64 );
+	DoWriteFixed( bits , 8 );
+}
+
+void stdBinaryWriter::Write( unsigned int field , float value )
+{
+	boost::uint32_t bits;
+	memcpy( &bits , &value , sizeof(bits) );
+
+	DoWriteKey( field , stdBINARY_FIXED32 );
+	DoWriteFixed( bits , 4 );
+}
+
+void stdBinaryWriter::Write( unsigned int field , const std::string& value )
+{
+	DoWriteKey( field , stdBINARY_LENGTH );
+	DoWriteVarint( value.size() );
+	m_out->append( value );
+}
+
+size_t stdBinaryWriter::StartMessage( unsigned int field )
+{
+	DoWriteKey( field , stdBINARY_LENGTH );
+
+	/* most objects are less than 128 bytes long so we reserve a single byte
+	 * for the length, EndMessage makes room for longer ones.
+	 */
+	m_out->push_back( 0 );
+	return m_out->size();
+}
+
+void stdBinaryWriter::EndMessage( size_t mark )
+{
+	char buffer[stdBINARY_VARINT_SIZE];
+	int count = stdBinaryEncodeVarint( buffer , m_out->size() - mark );
+
+	m_out->replace( mark - 1 , 1 , buffer , count );
+}
+
+bool stdBinaryReader::Next()
+{
+	if( m_data >= m_end )
+		return false;
+
+	unsigned long key = DoReadVarint();
+	m_field = (unsigned int) ( key >> 3 );
+	m_type = (unsigned int) ( key & 0x7 );
+
+	return true;
+}
+
+unsigned long stdBinaryReader::DoReadVarint()
+{
+	unsigned long value = 0;
+
+	for( unsigned int shift = 0 ; shift < 64 ; shift += 7 ) {
+		if( m_data >= m_end )
+			STD_THROW("Error truncated binary data!");
+
+		unsigned char byte = *m_data++;
+		value |= (unsigned long) ( byte & 0x7F ) << shift;
+
+		if( ( byte & 0x80 ) == 0 )
+			return value;
+	}
+
+	STD_THROW("Error invalid binary data!");
+}
+
+boost::uint64_t stdBinaryReader::DoReadFixed( int bytes )
+{
+	if( m_end - m_data < bytes )
+		STD_THROW("Error truncated binary data!");
+
+	boost::uint64_t value = 0;
+
+	for( int i = bytes - 1 ; i >= 0 ; --i )
+		value = ( value << 8 ) | m_data[i];
+
+	m_data += bytes;
+	return value;
+}
+
+size_t stdBinaryReader::DoReadLength()
+{
+	unsigned long length = DoReadVarint();
+
+	if( length > (unsigned long) ( m_end - m_data ) )
+		STD_THROW("Error truncated binary data!");
+
+	return (size_t) length;
+}
+
+void stdBinaryReader::Skip()
+{
+	switch( m_type )
+	{
+	case stdBINARY_VARINT :
+		DoReadVarint();
+		break;
+	case stdBINARY_FIXED64 :
+		DoReadFixed( 8 );
+		break;
+	case stdBINARY_LENGTH :
+		m_data += DoReadLength();
+		break;
+	case stdBINARY_FIXED32 :
+		DoReadFixed( 4 );
+		break;
+	default :
+		STD_THROW("Error invalid binary data!");
+	}
+}
+
+bool stdBinaryReader::DoCheckType( unsigned int type )
+{
+	if( m_type == type )
+		return true;
+
+	Skip();
+	return false;
+}
+
+bool stdBinaryReader::Read( int& value )
+{
+	long ret;
+
+	if( !Read( ret ) )
+		return false;
+
+	value = (int) ret;
+	return true;
+}
+
+bool stdBinaryReader::Read( unsigned int& value )
+{
+	unsigned long ret;
+
+	if( !Read( ret ) )
+		return false;
+
+	value = (unsigned int) ret;
+	return true;
+}
+
+bool stdBinaryReader::Read( long& value )
+{
+	if( !DoCheckType( stdBINARY_VARINT ) )
+		return false;
+
+	value = stdBinaryUnZigZag( DoReadVarint() );
+	return true;
+}
+
+bool stdBinaryReader::Read( unsigned long& value )
+{
+	if( !DoCheckType( stdBINARY_VARINT ) )
+		return false;
+
+	value = DoReadVarint();
+	return true;
+}
+
+bool stdBinaryReader::Read( bool& value )
+{
+	if( !DoCheckType( stdBINARY_VARINT ) )
+		return false;
+
+	value = DoReadVarint() != 0;
+	return true;
+}
+
+bool stdBinaryReader::Read( double& value )
+{
+	if( !DoCheckType( stdBINARY_FIXED64 ) )
+		return false;
+
+	boost::uint64_t bits = DoReadFixed( 8 );
+	memcpy( &value , &bits , sizeof(bits) );
+	return true;
+}
+
+bool stdBinaryReader::Read( float& value )
+{
+	if( !DoCheckType( stdBINARY_FIXED32 ) )
+		return false;
+
+	boost::uint32_t bits = (boost::uint32_t) DoReadFixed( 4 );
+	memcpy( &value , &bits , sizeof(bits) );
+	return true;
+}
+
+bool stdBinaryReader::Read( std::string& value )
+{
+	if( !DoCheckType( stdBINARY_LENGTH ) )
+		return false;
+
+	size_t length = DoReadLength();
+	value.assign( (const char*) m_data , length );
+	m_data += length;
+	return true;
+}
+
+bool stdBinaryReader::ReadMessage( stdBinaryReader& message )
+{
+	if( !DoCheckType( stdBINARY_LENGTH ) )
+		return false;
+
+	size_t length = DoReadLength();
+	message = stdBinaryReader( (const char*) m_data , length );
+	m_data += length;
+	return true;
+}
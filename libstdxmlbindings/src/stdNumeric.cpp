@@ -0,0 +1,258 @@
+/**
+ * @file stdNumeric.cpp
+ * @brief numeric values parsing and formatting for reading and writing xml files
+ * @author Nicolas Macherey (nm@graymat.fr)
+ * @version 10.4
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#if __cplusplus >= 201703L
+#include <charconv>
+#endif
+
+#include "stdNumeric.h"
+
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+#define stdUSE_CHARCONV 1
+#endif
+
+/** Skip xml whitespaces and a leading '+' */
+static const char* stdSkipNumberPrefix( const char* str )
+{
+	while( *str == ' ' || *str == '\t' || *str == '\n' || *str == '\r' )
+		++str;
+
+	if( *str == '+' )
+		++str;
+
+	return str;
+}
+
+/** Read the digits of an unsigned value
+  * @param str string to read, positionned on the first digit
+  * @param max maximum value, the result is clamped to it
+  * @param value [out] read value
+  * @return false if there are no digits
+  */
+static bool stdParseDigits( const char* str , unsigned long max , unsigned long& value )
+{
+	if( *str < '0' || *str > '9' )
+		return false;
+
+	unsigned long ret = 0;
+	bool overflow = false;
+
+	for( ; *str >= '0' && *str <= '9' ; ++str ) {
+		unsigned long digit = *str - '0';
+
+		if( ret > ( max - digit ) / 10 )
+			overflow = true;
+		else
+			ret = ret * 10 + digit;
+	}
+
+	value = overflow ? max : ret;
+	return true;
+}
+
+/** Read a signed value clamped to [min,max] */
+static bool stdParseSigned( const char* str , long min , long max , long& value )
+{
+	bool negative = false;
+
+	while( *str == ' ' || *str == '\t' || *str == '\n' || *str == '\r' )
+		++str;
+
+	if( *str == '-' || *str == '+' ) {
+		negative = ( *str == '-' );
+		++str;
+	}
+
+	unsigned long limit = negative ? (unsigned long) -( min + 1 ) + 1 : (unsigned long) max;
+	unsigned long digits;
+
+	if( !stdParseDigits( str , limit , digits ) )
+		return false;
+
+	if( negative )
+		value = digits == limit ? min : -( (long) digits );
+	else
+		value = (long) digits;
+
+	return true;
+}
+
+/** Read an unsigned value clamped to max, negative values wrap around like strtoul does */
+static bool stdParseUnsigned( const char* str , unsigned long max , unsigned long& value )
+{
+	bool negative = false;
+
+	while( *str == ' ' || *str == '\t' || *str == '\n' || *str == '\r' )
+		++str;
+
+	if( *str == '-' || *str == '+' ) {
+		negative = ( *str == '-' );
+		++str;
+	}
+
+	unsigned long digits;
+
+	if( !stdParseDigits( str , max , digits ) )
+		return false;
+
+	value = negative ? ( ( max - digits ) + 1 ) & max : digits;
+	return true;
+}
+
+bool stdParseNumber( const char* str , int& value )
+{
+	long ret;
+
+	if( !stdParseSigned( str , INT_MIN , INT_MAX , ret ) )
+		return false;
+
+	value = (int) ret;
+	return true;
+}
+
+bool stdParseNumber( const char* str , unsigned int& value )
+{
+	unsigned long ret;
+
+	if( !stdParseUnsigned( str , UINT_MAX , ret ) )
+		return false;
+
+	value = (unsigned int) ret;
+	return true;
+}
+
+bool stdParseNumber( const char* str , long& value )
+{
+	return stdParseSigned( str , LONG_MIN , LONG_MAX , value );
+}
+
+bool stdParseNumber( const char* str , unsigned long& value )
+{
+	return stdParseUnsigned( str , ULONG_MAX , value );
+}
+
+#ifdef stdUSE_CHARCONV
+template< class T > static bool stdParseFloating( const char* str , T& value )
+{
+	str = stdSkipNumberPrefix( str );
+
+	T ret;
+	std::from_chars_result res = std::from_chars( str , str + strlen( str ) , ret );
+
+	if( res.ec == std::errc() ) {
+		value = ret;
+		return true;
+	}
+
+	/* like stream extraction, out of range values are clamped to infinity or zero */
+	if( res.ec == std::errc::result_out_of_range ) {
+		value = (T) strtod( str , NULL );
+		return true;
+	}
+
+	return false;
+}
+#else
+template< class T > static bool stdParseFloating( const char* str , T& value )
+{
+	str = stdSkipNumberPrefix( str );
+
+	char* end;
+	double ret = strtod( str , &end );
+
+	if( end == str )
+		return false;
+
+	value = (T) ret;
+	return true;
+}
+#endif
+
+bool stdParseNumber( const char* str , double& value )
+{
+	return stdParseFloating( str , value );
+}
+
+bool stdParseNumber( const char* str , float& value )
+{
+	return stdParseFloating( str , value );
+}
+
+int stdFormatNumber( char* buffer , unsigned long value )
+{
+	char digits[stdNUMERIC_BUFFER_SIZE];
+	int count = 0;
+
+	do {
+		digits[count++] = (char) ( '0' + value % 10 );
+		value /= 10;
+	} while( value != 0 );
+
+	for( int i = 0; i < count ; ++i )
+		buffer[i] = digits[count - i - 1];
+
+	buffer[count] = 0;
+	return count;
+}
+
+int stdFormatNumber( char* buffer , long value )
+{
+	if( value >= 0 )
+		return stdFormatNumber( buffer , (unsigned long) value );
+
+	buffer[0] = '-';
+	return 1 + stdFormatNumber( buffer + 1 , (unsigned long) -( value + 1 ) + 1 );
+}
+
+int stdFormatNumber( char* buffer , int value )
+{
+	return stdFormatNumber( buffer , (long) value );
+}
+
+int stdFormatNumber( char* buffer , unsigned int value )
+{
+	return stdFormatNumber( buffer , (unsigned long) value );
+}
+
+#ifdef stdUSE_CHARCONV
+template< class T > static int stdFormatFloating( char* buffer , T value )
+{
+	std::to_chars_result res = std::to_chars( buffer , buffer + stdNUMERIC_BUFFER_SIZE - 1 , value );
+	*res.ptr = 0;
+	return (int) ( res.ptr - buffer );
+}
+#else
+/** find the shortest precision which reads back to the same value */
+template< class T > static int stdFormatFloating( char* buffer , T value )
+{
+	int precision = sizeof(T) == sizeof(float) ? 6 : 15;
+	int count = 0;
+
+	for( ; precision <= 17 ; ++precision ) {
+		count = snprintf( buffer , stdNUMERIC_BUFFER_SIZE , "%.*g" , precision , (double) value );
+
+		if( value != value || (T) strtod( buffer , NULL ) == value )
+			break;
+	}
+
+	return count;
+}
+#endif
+
+int stdFormatNumber( char* buffer , double value )
+{
+	return stdFormatFloating( buffer , value );
+}
+
+int stdFormatNumber( char* buffer , float value )
+{
+	return stdFormatFloating( buffer , value );
+}
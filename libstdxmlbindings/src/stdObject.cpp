@@ -11,6 +11,10 @@
 *******************************************************************************/
 #include <string.h>
 
+#if defined(stdATOMIC_REFCOUNT) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 #include "stdHashTable.h"
 #include "stdObject.h"
 
@@ -107,13 +111,13 @@ void stdObject::Ref(const stdObject& clone) {
 	// reference new data
 	if ( clone.m_refData ) {
 		m_refData = clone.m_refData;
-		++(m_refData->m_count);
+		m_refData->IncRef();
 	}
 }
 
 void stdObject::UnRef() {
 	if ( m_refData ) {
-		if ( --m_refData->m_count == 0 )
+		if ( m_refData->DecRef() )
 			delete m_refData;
 		m_refData = NULL;
 	}
@@ -123,12 +127,12 @@ void stdObject::AllocExclusive() {
 	if ( !m_refData ) {
 		m_refData = CreateRefData();
 	} else if ( m_refData->GetRefCount() > 1 ) {
-		// note that ref is not going to be destroyed in this case
-		const stdObjectRefData* ref = m_refData;
+		// clone before releasing our reference : once released, the other
+		// owners may destroy the data at any time
+		stdObjectRefData* ref = CloneRefData(m_refData);
 		UnRef();
 
-		// ... so we can still access it
-		m_refData = CloneRefData(ref);
+		m_refData = ref;
 	}
 	//else: ref count is 1, we are exclusive owners of m_refData anyhow
 }
@@ -136,6 +140,47 @@ void stdObject::AllocExclusive() {
 /*******************************************************************************
    CLASS stdObjectRefData DEFINITION
 *******************************************************************************/
+#if defined(stdATOMIC_REFCOUNT) && defined(__GNUC__)
+// increments do not need to be ordered, taking a reference requires to already
+// own one. Decrements release our writes to the data and the last one acquires
+// the writes of the other owners before deleting it.
+int stdObjectRefData::GetRefCount() const {
+	return __atomic_load_n(&m_count, __ATOMIC_ACQUIRE);
+}
+
+void stdObjectRefData::IncRef() {
+	__atomic_fetch_add(&m_count, 1, __ATOMIC_RELAXED);
+}
+
+bool stdObjectRefData::DecRef() {
+	return __atomic_sub_fetch(&m_count, 1, __ATOMIC_ACQ_REL) == 0;
+}
+#elif defined(stdATOMIC_REFCOUNT) && defined(_MSC_VER)
+int stdObjectRefData::GetRefCount() const {
+	return _InterlockedCompareExchange((volatile long*) &m_count, 0, 0);
+}
+
+void stdObjectRefData::IncRef() {
+	_InterlockedIncrement((volatile long*) &m_count);
+}
+
+bool stdObjectRefData::DecRef() {
+	return _InterlockedDecrement((volatile long*) &m_count) == 0;
+}
+#else
+int stdObjectRefData::GetRefCount() const {
+	return m_count;
+}
+
+void stdObjectRefData::IncRef() {
+	++m_count;
+}
+
+bool stdObjectRefData::DecRef() {
+	return --m_count == 0;
+}
+#endif
+
 stdObjectRefData *stdObject::CreateRefData() const {
 	return NULL;
 }
@@ -0,0 +1,86 @@
+/**
+ * @file stdObjectPool.cpp
+ * @brief main file for recycling the instances of generated objects
+ * @author Nicolas Macherey (nm@graymat.fr)
+ * @version 10.4
+ */
+#include <libxml/xmlreader.h>
+#include <libxml/xpath.h>
+
+#include <vector>
+
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/tss.hpp>
+
+#include "stdObjectPool.h"
+
+/** instances kept by the pools of a thread, by slot */
+typedef std::vector< std::vector< stdObject* >* > stdObjectPoolSlots;
+
+/** Free the instances kept by a thread when it exits */
+static void stdFreeObjectPoolSlots( stdObjectPoolSlots* slots )
+{
+	for( size_t i = 0; i < slots->size() ; ++i ) {
+		std::vector< stdObject* >* items = (*slots)[i];
+
+		if( items == NULL )
+			continue;
+
+		for( size_t j = 0; j < items->size() ; ++j )
+			delete (*items)[j];
+
+		delete items;
+	}
+
+	delete slots;
+}
+
+static boost::thread_specific_ptr< stdObjectPoolSlots > stdObjectPoolThreadSlots( &stdFreeObjectPoolSlots );
+static boost::mutex stdObjectPoolMutex;
+static unsigned int stdObjectPoolLastSlot = 0;
+
+unsigned int stdObjectPoolStorage::NewSlot()
+{
+	boost::mutex::scoped_lock lock( stdObjectPoolMutex );
+	return stdObjectPoolLastSlot++;
+}
+
+std::vector< stdObject* >* stdObjectPoolStorage::GetItems( unsigned int slot , bool create )
+{
+	stdObjectPoolSlots* slots = stdObjectPoolThreadSlots.get();
+
+	if( slots == NULL ) {
+		if( !create )
+			return NULL;
+
+		slots = new stdObjectPoolSlots;
+		stdObjectPoolThreadSlots.reset( slots );
+	}
+
+	if( slot >= slots->size() ) {
+		if( !create )
+			return NULL;
+
+		slots->resize( slot + 1 , NULL );
+	}
+
+	std::vector< stdObject* >*& items = (*slots)[slot];
+
+	if( items == NULL && create )
+		items = new std::vector< stdObject* >;
+
+	return items;
+}
+
+void stdObjectPoolStorage::Clear( unsigned int slot )
+{
+	std::vector< stdObject* >* items = GetItems( slot , false );
+
+	if( items == NULL )
+		return;
+
+	for( size_t i = 0; i < items->size() ; ++i )
+		delete (*items)[i];
+
+	items->clear();
+}
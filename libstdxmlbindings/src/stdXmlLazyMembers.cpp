@@ -0,0 +1,117 @@
+/**
+ * @file stdXmlLazyMembers.cpp
+ * @brief main file for loading the members of generated objects on first access
+ * @author Nicolas Macherey (nm@graymat.fr)
+ * @version 10.4
+ */
+#include <libxml/xmlreader.h>
+#include <libxml/xpath.h>
+
+#include <string>
+#include <vector>
+
+#include "stdDefines.h"
+#include "stdException.h"
+
+#include "stdXmlLazyMembers.h"
+#include "stdXmlLazySource.h"
+
+stdXmlLazyMembers& stdXmlLazyMembers::operator=( const stdXmlLazyMembers& rhs )
+{
+	if( this == &rhs )
+		return (*this);
+
+	Clear();
+
+	if( rhs.m_entries != NULL )
+		m_entries = new std::vector< stdXmlLazyEntry >( *rhs.m_entries );
+
+	return (*this);
+}
+
+void stdXmlLazyMembers::Clear()
+{
+	delete m_entries;
+	m_entries = NULL;
+}
+
+void stdXmlLazyMembers::Defer( const stdXmlLazySourcePtr& source , xmlNode* node , const char* className )
+{
+	if( m_entries == NULL )
+		m_entries = new std::vector< stdXmlLazyEntry >;
+
+	/* as when loading eagerly, the last element of a member wins */
+	for( size_t i = 0; i < m_entries->size() ; ++i ) {
+		stdXmlLazyEntry& entry = (*m_entries)[i];
+
+		if( xmlStrEqual( entry.node->name , node->name ) ) {
+			entry.source = source;
+			entry.node = node;
+			entry.className = className;
+			return;
+		}
+	}
+
+	m_entries->push_back( stdXmlLazyEntry() );
+
+	stdXmlLazyEntry& entry = m_entries->back();
+	entry.source = source;
+	entry.node = node;
+	entry.className = className;
+}
+
+void stdXmlLazyMembers::DeferRun( const stdXmlLazySourcePtr& source , xmlNode* node , const char* className )
+{
+	if( m_entries == NULL )
+		m_entries = new std::vector< stdXmlLazyEntry >;
+
+	/* the following elements of the array are found from the first one */
+	for( size_t i = 0; i < m_entries->size() ; ++i )
+		if( xmlStrEqual( (*m_entries)[i].node->name , node->name ) )
+			return;
+
+	m_entries->push_back( stdXmlLazyEntry() );
+
+	stdXmlLazyEntry& entry = m_entries->back();
+	entry.source = source;
+	entry.node = node;
+	entry.className = className;
+}
+
+bool stdXmlLazyMembers::DoTake( const char* name , stdXmlLazyEntry* entry )
+{
+	for( size_t i = 0; i < m_entries->size() ; ++i ) {
+		if( !xmlStrEqual( (*m_entries)[i].node->name , (const xmlChar*) name ) )
+			continue;
+
+		if( entry != NULL )
+			*entry = (*m_entries)[i];
+
+		m_entries->erase( m_entries->begin() + i );
+
+		if( m_entries->empty() )
+			Clear();
+
+		return true;
+	}
+
+	return false;
+}
+
+stdObject* stdXmlLazyMembers::DoLoadNode( const stdXmlLazyEntry& entry , stdObject* instance )
+{
+	return entry.source->Load( entry.node , entry.className , instance );
+}
+
+void stdXmlLazyMembers::DoLoadNodes( const stdXmlLazyEntry& entry , const std::vector< xmlNode* >& nodes ,
+		const std::vector< stdObject* >& instances , std::vector< stdObject* >& results )
+{
+	entry.source->LoadNodes( nodes , entry.className , instances , results );
+}
+
+void stdXmlLazyMembers::DoCollectRun( xmlNode* node , std::vector< xmlNode* >& nodes )
+{
+	for( xmlNode* sibling = node ; sibling != NULL ; sibling = sibling->next )
+		if( sibling->type == XML_ELEMENT_NODE && xmlStrEqual( sibling->name , node->name ) )
+			nodes.push_back( sibling );
+}
@@ -0,0 +1,88 @@
+/**
+ * @file stdXmlLazySource.cpp
+ * @brief main file for keeping the documents loaded lazily
+ * @author Nicolas Macherey (nm@graymat.fr)
+ * @version 10.4
+ */
+#include <libxml/xmlreader.h>
+#include <libxml/xpath.h>
+
+#include <string>
+#include <vector>
+
+#include "stdDefines.h"
+#include "stdException.h"
+
+#include "stdXmlLazySource.h"
+
+stdXmlLazySource::stdXmlLazySource( xmlDoc* doc , unsigned int threads , unsigned int threshold ):
+	m_doc(doc),
+	m_context(NULL),
+	m_threads(threads),
+	m_threshold(threshold)
+{
+}
+
+stdXmlLazySource::~stdXmlLazySource()
+{
+	delete m_context;
+	xmlFreeDoc( m_doc );
+}
+
+stdXmlParseContext* stdXmlLazySource::DoGetContext()
+{
+	if( m_context == NULL ) {
+		m_context = new stdXmlParseContext;
+		m_context->SetParallelism( m_threads , m_threshold );
+		m_context->m_doc = m_doc;
+		m_context->m_root = xmlDocGetRootElement( m_doc );
+		m_context->DoSetIndexDict( m_doc->dict );
+	}
+
+	return m_context;
+}
+
+stdObject* stdXmlLazySource::Load( xmlNode* node , const std::string& className , stdObject* instance )
+{
+	boost::recursive_mutex::scoped_lock lock( m_mutex );
+	stdXmlParseContext* context = DoGetContext();
+
+	/* the context only refers to the source while loading, otherwise the source
+	 * would never be freed
+	 */
+	stdXmlLazySourcePtr source = context->m_lazySource;
+	context->m_lazySource = shared_from_this();
+
+	stdObject* result = NULL;
+
+	try {
+		result = context->CreateResFromNode( node , className , instance );
+	}
+	catch( ... ) {
+		context->m_lazySource = source;
+		throw;
+	}
+
+	context->m_lazySource = source;
+	return result;
+}
+
+void stdXmlLazySource::LoadNodes( const std::vector< xmlNode* >& nodes , const std::string& className ,
+		const std::vector< stdObject* >& instances , std::vector< stdObject* >& results )
+{
+	boost::recursive_mutex::scoped_lock lock( m_mutex );
+	stdXmlParseContext* context = DoGetContext();
+
+	stdXmlLazySourcePtr source = context->m_lazySource;
+	context->m_lazySource = shared_from_this();
+
+	try {
+		context->CreateResFromNodes( nodes , className , instances , results );
+	}
+	catch( ... ) {
+		context->m_lazySource = source;
+		throw;
+	}
+
+	context->m_lazySource = source;
+}
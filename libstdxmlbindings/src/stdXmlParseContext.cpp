@@ -0,0 +1,675 @@
+/**
+ * @file stdXmlParseContext.cpp
+ * @brief main file for reading and writing xml documents in a reentrant way
+ * @author Nicolas Macherey (nm@graymat.fr)
+ * @version 10.4
+ */
+#include <libxml/xmlreader.h>
+#include <libxml/xpath.h>
+#include <libxml/dict.h>
+
+#include <limits.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <exception>
+
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include "stdDefines.h"
+#include "stdException.h"
+
+#include "stdXmlReader.h"
+#include "stdXmlParseContext.h"
+#include "stdXmlLazySource.h"
+
+stdXmlParseContext::stdXmlParseContext():
+	m_table( stdXmlReader::Get()->GetDispatchTable() ),
+	m_handlers( m_table->GetCount() , (stdXmlHandler*) NULL ),
+	m_dictIndex(NULL),
+	m_indexDict(NULL),
+	m_indexInterned(false),
+	m_projection(NULL),
+	m_cursor(NULL),
+	m_doc(NULL),
+	m_root(NULL)
+{
+	stdXmlReader::Get()->GetParallelism( m_threads , m_threshold );
+	m_options = stdXmlReader::Get()->GetParseOptions();
+	m_lazy = stdXmlReader::Get()->IsLazy();
+	m_caching = stdXmlReader::Get()->IsFragmentCaching();
+}
+
+stdXmlParseContext::~stdXmlParseContext()
+{
+	for( unsigned int i = 0; i < m_handlers.size() ; ++i ) {
+		if( m_handlers[i] != NULL )
+			m_table->GetRegistration( i ).dtor( m_handlers[i] );
+	}
+
+	m_handlers.clear();
+
+	delete m_dictIndex;
+}
+
+/** @struct stdXmlParallelRun
+  * @brief State shared by the threads converting a run of elements in parallel.
+  * Threads claim chunks of nodes until all of them have been converted, so that
+  * threads converting small subtrees take more of them.
+  */
+struct stdXmlParallelRun
+{
+	stdXmlParallelRun( const std::vector< xmlNode* >& runNodes , const std::string& runClassName ,
+			const std::vector< stdObject* >& runInstances , std::vector< stdObject* >& runResults ,
+			xmlDict* runDict , const stdXmlLazySourcePtr& runLazySource , const stdXmlProjection* runCursor ,
+			unsigned int threads ):
+		nodes(runNodes),
+		className(runClassName),
+		instances(runInstances),
+		results(runResults),
+		dict(runDict),
+		lazySource(runLazySource),
+		cursor(runCursor),
+		next(0),
+		chunk(1),
+		failed(false),
+		line(0)
+	{
+		chunk = nodes.size() / ( 16 * threads );
+
+		if( chunk == 0 )
+			chunk = 1;
+	};
+
+	/** Claim the next chunk of nodes to convert
+	  * @return false once all nodes have been claimed or a thread failed
+	  */
+	bool Claim( size_t& begin , size_t& end )
+	{
+		boost::mutex::scoped_lock lock( mutex );
+
+		if( failed || next >= nodes.size() )
+			return false;
+
+		begin = next;
+		end = std::min( next + chunk , nodes.size() );
+		next = end;
+
+		return true;
+	};
+
+	/** Record the error of a thread, only the first one is kept */
+	void Fail( const std::string& errorMessage , const std::string& errorFile , int errorLine )
+	{
+		boost::mutex::scoped_lock lock( mutex );
+
+		if( failed )
+			return;
+
+		failed = true;
+		message = errorMessage;
+		file = errorFile;
+		line = errorLine;
+	};
+
+	const std::vector< xmlNode* >& nodes;
+	const std::string& className;
+	const std::vector< stdObject* >& instances;
+	std::vector< stdObject* >& results;
+	xmlDict* dict;
+	stdXmlLazySourcePtr lazySource;
+	const stdXmlProjection* cursor;
+
+	size_t next;
+	size_t chunk;
+
+	bool failed;
+	std::string message;
+	std::string file;
+	int line;
+
+	boost::mutex mutex;
+};
+
+/** @struct stdXmlMemoryInput
+  * @brief Buffer read by libxml2 through stdXmlReadMemoryInput
+  */
+struct stdXmlMemoryInput
+{
+	const char* data;
+	size_t size;
+};
+
+/** libxml2 input callback reading a stdXmlMemoryInput */
+static int stdXmlReadMemoryInput( void* context , char* buffer , int len )
+{
+	stdXmlMemoryInput* input = (stdXmlMemoryInput*) context;
+	size_t count = std::min( (size_t) len , input->size );
+
+	memcpy( buffer , input->data , count );
+	input->data += count;
+	input->size -= count;
+
+	return (int) count;
+}
+
+/** Check if the given data is compressed with gzip */
+static bool stdXmlIsCompressed( const char* data , size_t size )
+{
+	return size >= 2 && (unsigned char) data[0] == 0x1F && (unsigned char) data[1] == 0x8B;
+}
+
+xmlParserCtxt* stdXmlParseContext::DoCreateParser()
+{
+	xmlParserCtxt* parser = xmlNewParserCtxt();
+
+	if( parser == NULL )
+		STD_THROW("Error cannot create the xml parser!");
+
+	DoSetParserDict( parser );
+	return parser;
+}
+
+void stdXmlParseContext::DoSetParserDict( xmlParserCtxt* parser )
+{
+	if( ( m_options & XML_PARSE_NODICT ) != 0 )
+		return;
+
+	xmlDict* dict = m_table->CreateDict();
+
+	if( dict == NULL )
+		return;
+
+	/* the names of the parser are looked up again in the new dictionary, they
+	 * are compared by pointer while parsing.
+	 */
+	xmlDictFree( parser->dict );
+	parser->dict = dict;
+	parser->str_xml = xmlDictLookup( dict , BAD_CAST "xml" , 3 );
+	parser->str_xmlns = xmlDictLookup( dict , BAD_CAST "xmlns" , 5 );
+	parser->str_xml_ns = xmlDictLookup( dict , XML_XML_NAMESPACE , -1 );
+}
+
+xmlDoc* stdXmlParseContext::DoParseMemory( const char* data , size_t size , const char* url )
+{
+	xmlParserCtxt* parser = DoCreateParser();
+	xmlDoc* doc = NULL;
+
+	if( size <= INT_MAX )
+		doc = xmlCtxtReadMemory( parser , data , (int) size , url , NULL , m_options );
+	else {
+		/* xmlReadMemory cannot take more than 2GB, larger documents are read in
+		 * chunks from the buffer.
+		 */
+		stdXmlMemoryInput input = { data , size };
+		doc = xmlCtxtReadIO( parser , &stdXmlReadMemoryInput , NULL , &input , url , NULL , m_options );
+	}
+
+	xmlFreeParserCtxt( parser );
+	return doc;
+}
+
+stdObject* stdXmlParseContext::LoadFile( const std::string& file )
+{
+	/* the file is mapped in memory and parsed in place instead of being
+	 * copied by read calls. Compressed files and files which cannot be mapped,
+	 * like empty files or pipes, are read by libxml2.
+	 */
+	boost::iostreams::mapped_file_source mapping;
+
+	try {
+		mapping.open( file );
+	}
+	catch( std::exception& ) {
+	}
+
+	xmlDoc* doc = NULL;
+
+	if( mapping.is_open() && !stdXmlIsCompressed( mapping.data() , mapping.size() ) )
+		doc = DoParseMemory( mapping.data() , mapping.size() , file.c_str() );
+	else {
+		xmlParserCtxt* parser = DoCreateParser();
+		doc = xmlCtxtReadFile( parser , file.c_str() , NULL , m_options );
+		xmlFreeParserCtxt( parser );
+	}
+
+	if( doc == NULL )
+		STD_THROW("Error cannot open document!");
+
+	return DoLoadDocument( doc );
+}
+
+stdObject* stdXmlParseContext::Load( const std::string& data )
+{
+	xmlDoc* doc = DoParseMemory( data.c_str() , data.size() , NULL );
+
+	if( doc == NULL )
+		STD_THROW("Error cannot open document!");
+
+	return DoLoadDocument( doc );
+}
+
+stdObject* stdXmlParseContext::DoLoadDocument( xmlDoc* doc )
+{
+	xmlNode* root = xmlDocGetRootElement( doc );
+
+	if( root == NULL ) {
+		xmlFreeDoc( doc );
+		STD_THROW("Error cannot get your document root !");
+	}
+
+	if( root->name == NULL || *root->name == 0 ) {
+		xmlFreeDoc( doc );
+		STD_THROW( "Error document root is empty" );
+	}
+
+	xmlDoc* myDoc = m_doc;
+	xmlNode* myRoot = m_root;
+
+	m_doc = doc;
+	m_root = root;
+
+	/* a document loaded lazily is kept by the objects whose members have been
+	 * deferred, it is freed once all of them have been loaded.
+	 */
+	stdXmlLazySourcePtr myLazySource = m_lazySource;
+	m_lazySource.reset();
+
+	if( m_lazy )
+		m_lazySource.reset( new stdXmlLazySource( doc , m_threads , m_threshold ) );
+
+	/* Once we have extracted the root from the document, we have to
+   	 * find a handler which is able to return an object associated to
+	 * this root.
+	 */
+	xmlDict* dict = DoSetIndexDict( m_doc->dict );
+	const stdXmlProjection* cursor = m_cursor;
+	stdObject* resource = NULL;
+
+	m_cursor = DoGetRootCursor();
+
+	try {
+		resource = CreateResFromNode( m_root , stdEmptyString , NULL , NULL );
+	}
+	catch( ... ) {
+		DoSetIndexDict( dict );
+		m_cursor = cursor;
+
+		if( !m_lazy )
+			xmlFreeDoc( m_doc );
+
+		m_doc = myDoc;
+		m_root = myRoot;
+		m_lazySource = myLazySource;
+		throw;
+	}
+
+	DoSetIndexDict( dict );
+	m_cursor = cursor;
+
+	if( !m_lazy )
+		xmlFreeDoc( m_doc );
+
+	m_doc = myDoc;
+	m_root = myRoot;
+	m_lazySource = myLazySource;
+
+	return resource;
+}
+
+stdObject* stdXmlParseContext::LoadFileStreaming( const std::string& file )
+{
+	xmlTextReaderPtr reader = xmlReaderForFile( file.c_str() , NULL , m_options );
+
+	if( reader == NULL )
+		STD_THROW("Error cannot open document!");
+
+	return LoadStream( reader );
+}
+
+stdObject* stdXmlParseContext::LoadStreaming( const std::string& data )
+{
+	xmlTextReaderPtr reader = xmlReaderForMemory( data.c_str() , data.size() , NULL , NULL , m_options );
+
+	if( reader == NULL )
+		STD_THROW("Error cannot open document!");
+
+	return LoadStream( reader );
+}
+
+stdObject* stdXmlParseContext::LoadStream( xmlTextReaderPtr reader )
+{
+	int ret = xmlTextReaderRead( reader );
+
+	while( ret == 1 && xmlTextReaderNodeType( reader ) != XML_READER_TYPE_ELEMENT )
+		ret = xmlTextReaderRead( reader );
+
+	if( ret != 1 ) {
+		xmlFreeTextReader( reader );
+		STD_THROW("Error cannot get your document root !");
+	}
+
+	/* Once we have reached the root element, we have to find a handler
+	 * which is able to return an object associated to this root.
+	 */
+	xmlNode* root = xmlTextReaderCurrentNode( reader );
+	xmlDict* dict = DoSetIndexDict( root->doc != NULL ? root->doc->dict : NULL );
+	const stdXmlProjection* cursor = m_cursor;
+	stdObject* resource = NULL;
+
+	m_cursor = DoGetRootCursor();
+
+	/* the names interned in the dictionary of the reader are freed with it, the
+	 * index shall not keep them when the context is used again.
+	 */
+	try {
+		resource = CreateResFromStream( reader , stdEmptyString , NULL , NULL );
+	}
+	catch( ... ) {
+		DoSetIndexDict( dict );
+		m_cursor = cursor;
+		xmlFreeTextReader( reader );
+		throw;
+	}
+
+	m_cursor = cursor;
+	DoSetIndexDict( dict );
+
+	/* Read what remains of the document so that errors located after the
+	 * point where the handlers stopped are reported as well.
+	 */
+	while( ret == 1 )
+		ret = xmlTextReaderRead( reader );
+
+	xmlFreeTextReader( reader );
+
+	if( ret < 0 ) {
+		delete resource;
+		STD_THROW("Error cannot open document!");
+	}
+
+	return resource;
+}
+
+void stdXmlParseContext::SaveFile( const std::string& file , stdObject* resource )
+{
+	/* do not create the file if the resource cannot be written */
+	if( resource == NULL || DoFindHandler( resource ) == NULL )
+		STD_THROW("Error cannot get your document root !");
+
+	stdXmlWriter writer( file.c_str() , true , "UTF-8" );
+	writer.SetFragmentCaching( m_caching );
+	Save( writer , resource );
+}
+
+std::string stdXmlParseContext::StringSerialize( stdObject* resource )
+{
+	std::string ret;
+	stdXmlWriter writer( ret );
+	writer.SetFragmentCaching( m_caching );
+	Save( writer , resource );
+
+	return ret;
+}
+
+void stdXmlParseContext::Save( stdXmlWriter& writer , stdObject* resource )
+{
+	stdXmlHandler* handler = resource != NULL ? DoFindHandler( resource ) : NULL;
+
+	if( handler == NULL )
+		STD_THROW("Error cannot get your document root !");
+
+	writer.StartDocument();
+	handler->WriteResourceToStream( resource , &writer );
+	writer.EndDocument();
+}
+
+stdXmlHandler* stdXmlParseContext::DoGetHandler( unsigned int slot )
+{
+	stdXmlHandler* handler = m_handlers[slot];
+
+	if( handler == NULL ) {
+		handler = m_table->GetRegistration( slot ).ctor( );
+		handler->m_context = this;
+		handler->m_names = &m_table->GetNames( slot );
+		m_handlers[slot] = handler;
+	}
+
+	return handler;
+}
+
+stdXmlHandler* stdXmlParseContext::DoFindHandler( const std::string& className )
+{
+	if( !className.empty() ) {
+		int slot = m_table->FindClass( className.c_str() );
+
+		if( slot != stdNOT_FOUND )
+			return DoGetHandler( slot );
+	}
+
+	const std::vector< unsigned int >& unindexed = m_table->GetUnindexed();
+
+	for( unsigned int i = 0; i < unindexed.size() ; ++i ) {
+		stdXmlHandler* handler = DoGetHandler( unindexed[i] );
+
+		if( handler->CanHandle( className ) )
+			return handler;
+	}
+
+	return NULL;
+}
+
+stdXmlHandler* stdXmlParseContext::DoFindHandler( xmlNode* node )
+{
+	if( node->type == XML_ELEMENT_NODE && node->name != NULL ) {
+		/* names of the document being loaded are interned in its dictionary, so
+		 * we can find them by pointer without hashing and comparing strings.
+		 */
+		bool interned = sizeof(long) >= sizeof(void*) && m_indexDict != NULL &&
+			node->doc != NULL && node->doc->dict == m_indexDict;
+		stdXmlHandler* handler = NULL;
+
+		/* names known by the handlers are the table's own strings */
+		if( interned && m_indexInterned ) {
+			int slot = m_table->FindInterned( node->name );
+
+			if( slot != stdNOT_FOUND )
+				return DoGetHandler( slot );
+		}
+
+		if( interned ) {
+			handler = (stdXmlHandler*) m_dictIndex->Get( stdXmlHashPointer( node->name ) , (long) node->name );
+
+			if( handler != NULL )
+				return handler;
+		}
+
+		int slot = m_table->FindNode( (const char*) node->name );
+
+		if( slot != stdNOT_FOUND ) {
+			handler = DoGetHandler( slot );
+
+			if( interned && xmlDictOwns( m_indexDict , node->name ) == 1 )
+				m_dictIndex->Put( stdXmlHashPointer( node->name ) , (long) node->name , handler );
+
+			return handler;
+		}
+	}
+
+	const std::vector< unsigned int >& unindexed = m_table->GetUnindexed();
+
+	for( unsigned int i = 0; i < unindexed.size() ; ++i ) {
+		stdXmlHandler* handler = DoGetHandler( unindexed[i] );
+
+		if( handler->CanHandle( node ) )
+			return handler;
+	}
+
+	return NULL;
+}
+
+stdXmlHandler* stdXmlParseContext::DoFindHandler( stdObject* resource )
+{
+	int slot = m_table->FindClass( resource->GetClassInfo()->GetClassName() );
+
+	if( slot != stdNOT_FOUND )
+		return DoGetHandler( slot );
+
+	const std::vector< unsigned int >& unindexed = m_table->GetUnindexed();
+
+	for( unsigned int i = 0; i < unindexed.size() ; ++i ) {
+		stdXmlHandler* handler = DoGetHandler( unindexed[i] );
+
+		if( handler->CanHandle( resource ) )
+			return handler;
+	}
+
+	return NULL;
+}
+
+void stdXmlParseContext::SetParallelism( unsigned int threads , unsigned int threshold )
+{
+	m_threads = threads;
+	m_threshold = threshold;
+}
+
+void stdXmlParseContext::CreateResFromNodes( const std::vector< xmlNode* >& nodes , const std::string& className ,
+		const std::vector< stdObject* >& instances , std::vector< stdObject* >& results )
+{
+	results.assign( nodes.size() , (stdObject*) NULL );
+
+	unsigned int threads = m_threads;
+
+	if( threads == 0 )
+		threads = boost::thread::hardware_concurrency();
+
+	if( threads > nodes.size() )
+		threads = nodes.size();
+
+	if( threads <= 1 || nodes.size() < m_threshold ) {
+		for( size_t i = 0; i < nodes.size() ; ++i )
+			results[i] = CreateResFromNode( nodes[i] , className , instances[i] );
+
+		return;
+	}
+
+	/* the calling thread works as well, each thread works in its own context
+	 * as contexts and their handlers cannot be shared.
+	 */
+	stdXmlParallelRun run( nodes , className , instances , results , m_indexDict , m_lazySource , m_cursor , threads );
+	boost::thread_group workers;
+
+	for( unsigned int i = 1; i < threads ; ++i )
+		workers.create_thread( boost::bind( &stdXmlParseContext::DoRunWorker , &run ) );
+
+	DoRunWorker( &run );
+	workers.join_all();
+
+	if( run.failed )
+		throw stdException( run.message , run.file , run.line );
+}
+
+void stdXmlParseContext::DoRunWorker( stdXmlParallelRun* run )
+{
+	stdXmlParseContext context;
+	context.SetParallelism( 1 );
+	context.DoSetIndexDict( run->dict );
+	context.m_lazySource = run->lazySource;
+	context.m_cursor = run->cursor;
+
+	size_t begin , end;
+
+	while( run->Claim( begin , end ) ) {
+		try {
+			for( size_t i = begin; i < end ; ++i )
+				run->results[i] = context.CreateResFromNode( run->nodes[i] , run->className , run->instances[i] );
+		}
+		catch( stdException& e ) {
+			run->Fail( e.m_message , e.m_file , e.m_line );
+		}
+		catch( ... ) {
+			run->Fail( "Error while loading a run of elements" , __FILE__ , __LINE__ );
+		}
+	}
+}
+
+xmlDict* stdXmlParseContext::DoSetIndexDict( xmlDict* dict )
+{
+	xmlDict* old = m_indexDict;
+
+	if( dict != m_indexDict ) {
+		m_indexDict = dict;
+		m_indexInterned = m_table->IsInherited( dict );
+
+		if( m_dictIndex != NULL )
+			m_dictIndex->Clear();
+		else if( dict != NULL )
+			m_dictIndex = new stdHashTable( ktKEY_INTEGER , 2 * m_table->GetCount() + 31 );
+	}
+
+	return old;
+}
+
+stdObject *stdXmlParseContext::DoCreateResFromNode(xmlNode *node, const std::string& className , stdObject *resource,stdXmlHandler *handlerToUse)
+{
+	if( handlerToUse != NULL )
+		return handlerToUse->CreateResource( node , className , resource );
+
+	stdObject* result = NULL;
+	stdXmlHandler *handler = DoFindHandler( className );
+
+	if( handler == NULL )
+		handler = DoFindHandler( node );
+
+	if( handler != NULL )
+		result = handler->CreateResource( node , className , resource );
+
+	return result;
+}
+
+stdObject *stdXmlParseContext::DoCreateResFromStream(xmlTextReaderPtr reader, const std::string& className , stdObject *resource,stdXmlHandler *handlerToUse)
+{
+	if( handlerToUse != NULL )
+		return handlerToUse->CreateResourceFromStream( reader , className , resource );
+
+	stdObject* result = NULL;
+	stdXmlHandler *handler = DoFindHandler( className );
+
+	if( handler == NULL )
+		handler = DoFindHandler( xmlTextReaderCurrentNode( reader ) );
+
+	if( handler != NULL )
+		result = handler->CreateResourceFromStream( reader , className , resource );
+
+	return result;
+}
+
+xmlNode* stdXmlParseContext::DoWriteResource( stdObject* resource, const char* nodename , stdXmlHandler* handlerToUse )
+{
+	if( handlerToUse != NULL )
+		return handlerToUse->WriteResource( resource, nodename );
+
+	xmlNode* node = NULL;
+	stdXmlHandler* handler = DoFindHandler( resource );
+
+	if( handler != NULL )
+		node = handler->WriteResource( resource, nodename );
+
+	return node;
+}
+
+bool stdXmlParseContext::DoWriteResourceToStream( stdObject* resource, stdXmlWriter* writer, const char* nodename , stdXmlHandler* handlerToUse )
+{
+	stdXmlHandler* handler = handlerToUse != NULL ? handlerToUse : DoFindHandler( resource );
+
+	if( handler == NULL )
+		return false;
+
+	handler->WriteResourceToStream( resource, writer, nodename );
+	return true;
+}
@@ -0,0 +1,81 @@
+/**
+ * @file stdXmlProjection.cpp
+ * @brief main file for loading only some members of the documents
+ * @author Nicolas Macherey (nm@graymat.fr)
+ * @version 10.4
+ */
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include "stdException.h"
+
+#include "stdXmlProjection.h"
+
+stdXmlProjection::~stdXmlProjection()
+{
+	for( size_t i = 0; i < m_children.size() ; ++i )
+		delete m_children[i].second;
+
+	m_children.clear();
+}
+
+void stdXmlProjection::Add( const std::string& path )
+{
+	stdXmlProjection* step = this;
+	size_t begin = 0;
+
+	while( begin <= path.size() ) {
+		size_t end = path.find( '/' , begin );
+
+		if( end == std::string::npos )
+			end = path.size();
+
+		std::string name = path.substr( begin , end - begin );
+		begin = end + 1;
+
+		if( name.empty() )
+			continue;
+
+		if( name[0] == '@' ) {
+			if( end != path.size() )
+				STD_THROW( "Error only the last step of a projection path can be an attribute : " + path );
+
+			step->m_attributes.push_back( name.substr( 1 ) );
+			return;
+		}
+
+		step = step->DoGetChild( name );
+	}
+
+	step->m_complete = true;
+}
+
+stdXmlProjection* stdXmlProjection::DoGetChild( const std::string& name )
+{
+	for( size_t i = 0; i < m_children.size() ; ++i )
+		if( m_children[i].first == name )
+			return m_children[i].second;
+
+	m_children.push_back( std::make_pair( name , new stdXmlProjection ) );
+	return m_children.back().second;
+}
+
+const stdXmlProjection* stdXmlProjection::FindChild( const char* name ) const
+{
+	for( size_t i = 0; i < m_children.size() ; ++i )
+		if( strcmp( m_children[i].first.c_str() , name ) == 0 )
+			return m_children[i].second;
+
+	return NULL;
+}
+
+bool stdXmlProjection::HasAttribute( const char* name ) const
+{
+	for( size_t i = 0; i < m_attributes.size() ; ++i )
+		if( strcmp( m_attributes[i].c_str() , name ) == 0 )
+			return true;
+
+	return false;
+}
@@ -0,0 +1,165 @@
+/**
+ * @file stdXmlPushParser.cpp
+ * @brief main file for reading xml documents given incrementally
+ * @author Nicolas Macherey (nm@graymat.fr)
+ * @version 10.4
+ */
+#include <libxml/xmlreader.h>
+#include <libxml/xpath.h>
+
+#include <string>
+#include <vector>
+#include <map>
+#include <deque>
+
+#include "stdDefines.h"
+#include "stdException.h"
+
+#include "stdXmlReader.h"
+#include "stdXmlPushParser.h"
+
+/** maximal size given to xmlParseChunk at once */
+#define stdXML_PUSH_CHUNK_SIZE ( 1 << 30 )
+
+stdXmlPushParser* stdXmlReader::OpenPush( bool records , const std::string& className )
+{
+	return new stdXmlPushParser( records , className );
+}
+
+stdXmlPushParser::stdXmlPushParser( bool records , const std::string& className ):
+	m_parser(NULL),
+	m_records(records),
+	m_className(className),
+	m_current(NULL),
+	m_finished(false)
+{
+	m_parser = xmlCreatePushParserCtxt( NULL , NULL , NULL , 0 , NULL );
+
+	if( m_parser == NULL )
+		STD_THROW("Error cannot create the xml parser!");
+
+	xmlCtxtUseOptions( m_parser , m_context.GetParseOptions() );
+	m_context.DoSetParserDict( m_parser );
+}
+
+stdXmlPushParser::~stdXmlPushParser()
+{
+	if( m_current != NULL )
+		delete m_current;
+
+	for( unsigned int i = 0; i < m_pending.size() ; ++i )
+		delete m_pending[i];
+
+	if( m_parser->myDoc != NULL )
+		xmlFreeDoc( m_parser->myDoc );
+
+	xmlFreeParserCtxt( m_parser );
+}
+
+void stdXmlPushParser::Feed( const char* data , size_t size )
+{
+	if( m_finished )
+		STD_THROW("Error the document is already complete!");
+
+	/* xmlParseChunk takes int sizes */
+	while( size > stdXML_PUSH_CHUNK_SIZE ) {
+		DoParseChunk( data , stdXML_PUSH_CHUNK_SIZE , false );
+		data += stdXML_PUSH_CHUNK_SIZE;
+		size -= stdXML_PUSH_CHUNK_SIZE;
+	}
+
+	DoParseChunk( data , size , false );
+
+	if( m_records )
+		DoReadRecords( false );
+}
+
+stdObject* stdXmlPushParser::Finish()
+{
+	if( m_finished )
+		STD_THROW("Error the document is already complete!");
+
+	m_finished = true;
+	DoParseChunk( NULL , 0 , true );
+
+	if( m_parser->myDoc == NULL || xmlDocGetRootElement( m_parser->myDoc ) == NULL )
+		STD_THROW("Error cannot get your document root !");
+
+	if( m_records ) {
+		DoReadRecords( true );
+		return NULL;
+	}
+
+	/* the document is handed over to the context which frees it */
+	xmlDoc* doc = m_parser->myDoc;
+	m_parser->myDoc = NULL;
+
+	return m_context.DoLoadDocument( doc );
+}
+
+void stdXmlPushParser::DoParseChunk( const char* data , size_t size , bool terminate )
+{
+	xmlParseChunk( m_parser , data , (int) size , terminate ? 1 : 0 );
+
+	/* once an error has been found the parser ignores the rest of the document */
+	if( !m_parser->wellFormed && ( m_context.GetParseOptions() & XML_PARSE_RECOVER ) == 0 )
+		STD_THROW("Error while reading document!");
+}
+
+void stdXmlPushParser::DoReadRecords( bool all )
+{
+	xmlDoc* doc = m_parser->myDoc;
+	xmlNode* root = doc != NULL ? xmlDocGetRootElement( doc ) : NULL;
+
+	if( root == NULL )
+		return;
+
+	if( m_rootName.empty() ) {
+		m_rootName = (const char*) root->name;
+		m_context.DoSetIndexDict( doc->dict );
+	}
+
+	/* the parser appends the nodes it reads to the last child of the root, so
+	 * a child having a next sibling is complete. The last child is left to the
+	 * parser until the end of the document, text read later may be merged in it.
+	 */
+	xmlNode* child = root->children;
+
+	while( child != NULL && ( all || child->next != NULL ) ) {
+		xmlNode* next = child->next;
+
+		if( child->type == XML_ELEMENT_NODE ) {
+			stdObject* record = m_context.CreateResFromNode( child , m_className , NULL , NULL );
+
+			if( record != NULL )
+				m_pending.push_back( record );
+		}
+
+		xmlUnlinkNode( child );
+		xmlFreeNode( child );
+		child = next;
+	}
+}
+
+stdObject* stdXmlPushParser::Next()
+{
+	if( m_current != NULL ) {
+		delete m_current;
+		m_current = NULL;
+	}
+
+	if( m_pending.empty() )
+		return NULL;
+
+	m_current = m_pending.front();
+	m_pending.pop_front();
+
+	return m_current;
+}
+
+stdObject* stdXmlPushParser::Release()
+{
+	stdObject* record = m_current;
+	m_current = NULL;
+	return record;
+}
@@ -7,6 +7,7 @@
  */
 #include <libxml/xmlreader.h>
 #include <libxml/xpath.h>
+#include <libxml/dict.h>
 
 #include <stdio.h>
 #include <iostream>
@@ -15,11 +16,13 @@
 #include <vector>
 #include <map>
 #include <stack>
+#include <algorithm>
 
 #include "stdDefines.h"
 #include "stdException.h"
 
 #include "stdXmlReader.h"
+#include "stdXmlParseContext.h"
 
 IMPLEMENT_ABSTRACT_CLASS_STD( stdXmlHandler , stdObject );
 
@@ -29,173 +32,265 @@ template<> stdXmlReader* stdSingleton<stdXmlReader>::instance = 0;
 /** Global isShutdown initialization for the stdXmlReader */
 template<> bool  stdSingleton<stdXmlReader>::isShutdown = false;
 
-stdXmlReader::stdXmlReader()
+/** Hash function used for indexing handlers by names (FNV-1a) */
+static long stdXmlHashName( const char* name )
 {
+	unsigned long hash = 2166136261UL;
 
+	while( *name ) {
+		hash ^= (unsigned char) *name++;
+		hash *= 16777619UL;
+	}
+
+	return (long) (hash & 0x7FFFFFFFUL);
 }
 
-stdXmlReader::~stdXmlReader()
+stdXmlDispatchTable::stdXmlDispatchTable( const std::vector< stdXmlHandlerRegistration >& handlers )
 {
-	m_registeredHandlers.clear();
+	/* keep chains short, the tables are rebuilt each time handlers are added
+	 * or removed so they do not need to grow.
+	 */
+	size_t size = 2 * handlers.size() + 31;
 
-	for( unsigned int i = 0; i < m_handlers.size(); ++i )
-		delete m_handlers[i];
+	m_classIndex = new stdHashTable( ktKEY_STRING , size );
+	m_nodeIndex = new stdHashTable( ktKEY_STRING , size );
+	m_internedIndex = new stdHashTable( ktKEY_INTEGER , size );
 
-	m_handlers.clear();
+	/* the parser looks "xml" up in the dictionary of each document, so it is
+	 * found in the dictionaries inheriting ours as our own string.
+	 */
+	m_dict = xmlDictCreate();
+
+	if( m_dict == NULL )
+		STD_THROW("Error cannot create the names dictionary!");
+
+	m_probe = xmlDictLookup( m_dict , (const xmlChar*) "xml" , -1 );
+
+	for( unsigned int i = 0; i < handlers.size() ; ++i ) {
+		stdXmlHandlerEntry* entry = new stdXmlHandlerEntry( handlers[i] , i );
+		m_entries.push_back( entry );
+
+		for( const char* const* name = entry->registration.names ; name != NULL && *name != NULL ; ++name )
+			entry->names.push_back( xmlDictLookup( m_dict , (const xmlChar*) *name , -1 ) );
+
+		if( entry->registration.className.empty() || entry->registration.nodeName.empty() )
+			m_unindexed.push_back( i );
+
+		/* when several handlers declare the same name, the first registered one
+		 * wins as it would with CanHandle.
+		 */
+		const char* className = entry->registration.className.c_str();
+
+		if( *className && m_classIndex->Get( stdXmlHashName( className ) , className ) == NULL )
+			m_classIndex->Put( stdXmlHashName( className ) , className , entry );
+
+		const char* nodeName = entry->registration.nodeName.c_str();
+
+		if( *nodeName && m_nodeIndex->Get( stdXmlHashName( nodeName ) , nodeName ) == NULL ) {
+			m_nodeIndex->Put( stdXmlHashName( nodeName ) , nodeName , entry );
+
+			const xmlChar* interned = xmlDictLookup( m_dict , (const xmlChar*) nodeName , -1 );
+
+			if( sizeof(long) >= sizeof(void*) )
+				m_internedIndex->Put( stdXmlHashPointer( interned ) , (long) interned , entry );
+		}
+	}
 }
 
-stdObject* stdXmlReader::LoadFile( const std::string& file )
-{	
-	m_doc = xmlParseFile( file.c_str() );
-	
-	if( m_doc == NULL )
-		STD_THROW("Error cannot open document!");
-	
-	m_root = xmlDocGetRootElement( m_doc );
-	
-	if( m_root == NULL )
-		STD_THROW("Error cannot get your document root !");
-		
-	std::string n_root = (char*) m_root->name;
+stdXmlDispatchTable::~stdXmlDispatchTable()
+{
+	delete m_classIndex;
+	delete m_nodeIndex;
+	delete m_internedIndex;
 
-	if( n_root.empty() )
-		STD_THROW( "Error document root is empty" );
+	/* dictionaries created by CreateDict keep a reference on ours */
+	xmlDictFree( m_dict );
 
-	/* Once we have extracted the root from the document, we have to 
-   	 * find a handler which is able to return an object associated to
-	 * this root.
-	 */
-	stdObject* resource = CreateResFromNode( m_root , stdEmptyString , NULL , NULL );
-	
-	xmlFreeDoc(m_doc);
+	for( unsigned int i = 0; i < m_entries.size() ; ++i )
+		delete m_entries[i];
+}
 
-	return resource;
+int stdXmlDispatchTable::FindClass( const char* className ) const
+{
+	stdXmlHandlerEntry* entry = (stdXmlHandlerEntry*) m_classIndex->Get( stdXmlHashName( className ) , className );
+	return entry != NULL ? (int) entry->slot : stdNOT_FOUND;
 }
 
-stdObject* stdXmlReader::Load( const std::string& data ) {
+int stdXmlDispatchTable::FindNode( const char* nodeName ) const
+{
+	stdXmlHandlerEntry* entry = (stdXmlHandlerEntry*) m_nodeIndex->Get( stdXmlHashName( nodeName ) , nodeName );
+	return entry != NULL ? (int) entry->slot : stdNOT_FOUND;
+}
 
-	m_doc = xmlParseMemory( data.c_str(), data.size() );
-	
-	if( m_doc == NULL )
-		STD_THROW("Error cannot open document!");
-	
-	m_root = xmlDocGetRootElement( m_doc );
-	
-	if( m_root == NULL )
-		STD_THROW("Error cannot get your document root !");
-		
-	std::string n_root = (char*) m_root->name;
+int stdXmlDispatchTable::FindInterned( const xmlChar* nodeName ) const
+{
+	if( sizeof(long) < sizeof(void*) )
+		return stdNOT_FOUND;
+
+	stdXmlHandlerEntry* entry = (stdXmlHandlerEntry*) m_internedIndex->Get( stdXmlHashPointer( nodeName ) , (long) nodeName );
+	return entry != NULL ? (int) entry->slot : stdNOT_FOUND;
+}
 
-	if( n_root.empty() )
-		STD_THROW( "Error document root is empty" );
+bool stdXmlDispatchTable::IsInherited( xmlDict* dict ) const
+{
+	return dict != NULL && xmlDictExists( dict , (const xmlChar*) "xml" , -1 ) == m_probe;
+}
 
-	/* Once we have extracted the root from the document, we have to 
-   	 * find a handler which is able to return an object associated to
-	 * this root.
+stdXmlReader::stdXmlReader():
+	m_threads(1),
+	m_threshold(stdXML_PARALLEL_THRESHOLD),
+	m_options(stdXML_PARSE_DEFAULT),
+	m_lazy(false),
+	m_caching(false)
+{
+	/* libxml2 has to be initialized once before documents are parsed from
+	 * several threads.
 	 */
-	stdObject* resource = CreateResFromNode( m_root , stdEmptyString , NULL , NULL );
-	
-	xmlFreeDoc(m_doc);
+	xmlInitParser();
+}
 
-	return resource;
+stdXmlReader::~stdXmlReader()
+{
+	m_table.reset();
+	m_handlers.clear();
+	m_registeredHandlers.clear();
+}
+
+stdObject* stdXmlReader::LoadFile( const std::string& file )
+{	
+	stdXmlParseContext context;
+	return context.LoadFile( file );
+}
+
+stdObject* stdXmlReader::Load( const std::string& data )
+{
+	stdXmlParseContext context;
+	return context.Load( data );
+}
+
+stdObject* stdXmlReader::LoadFileStreaming( const std::string& file )
+{
+	stdXmlParseContext context;
+	return context.LoadFileStreaming( file );
+}
+
+stdObject* stdXmlReader::LoadStreaming( const std::string& data )
+{
+	stdXmlParseContext context;
+	return context.LoadStreaming( data );
 }
 
 void stdXmlReader::SaveFile( const std::string& file , stdObject* resource )
 {
-	m_doc = xmlNewDoc((const xmlChar*) "1.0");
-	
-	if( m_doc == NULL )
-		STD_THROW("Error cannot open document!");
-	
-	m_root = WriteResource( resource );
-	
-	if( m_root == NULL )
-		STD_THROW("Error cannot get your document root !");
-		
-	xmlDocSetRootElement(m_doc,m_root);
-	xmlSaveFormatFileEnc( file.c_str() , m_doc , "UTF-8" , 1 );
-	
-	xmlFreeDoc(m_doc);
+	stdXmlParseContext context;
+	context.SaveFile( file , resource );
 }
 
-std::string stdXmlReader::StringSerialize( stdObject* resource ) {
-	
-    m_doc = xmlNewDoc((const xmlChar*) "1.0");
-	
-	if( m_doc == NULL )
-		STD_THROW("Error cannot open document!");
-	
-	m_root = WriteResource( resource );
-	
-	if( m_root == NULL )
-		STD_THROW("Error cannot get your document root !");
-		
-	xmlDocSetRootElement(m_doc,m_root);
-    xmlChar* data;
-    int size;
-    xmlDocDumpMemory(m_doc,&data,&size);
-    std::string ret = (char*) data;
-	xmlFreeDoc(m_doc);
-    xmlFree(data);
+std::string stdXmlReader::StringSerialize( stdObject* resource )
+{
+	stdXmlParseContext context;
+	return context.StringSerialize( resource );
+}
+
+void stdXmlReader::Save( stdXmlWriter& writer , stdObject* resource )
+{
+	stdXmlParseContext context;
+	context.Save( writer , resource );
+}
 
-    return ret;
+stdObject *stdXmlReader::CreateResFromNode(xmlNode *node , const std::string& className, stdObject *resource, stdXmlHandler* handlerToUse)
+{
+	stdXmlParseContext context;
+	return context.CreateResFromNode( node , className , resource , handlerToUse );
+}
+
+stdObject *stdXmlReader::CreateResFromStream(xmlTextReaderPtr reader , const std::string& className, stdObject *resource, stdXmlHandler* handlerToUse)
+{
+	stdXmlParseContext context;
+	return context.CreateResFromStream( reader , className , resource , handlerToUse );
 }
 
 bool stdXmlReader::HasHandlerFor( xmlNode* node )
 {
-	for( unsigned int i = 0 ; i < m_handlers.size() ; ++i )
-		if( m_handlers[i]->CanHandle( node ) )
-			return true;
+	stdXmlParseContext context;
+	return context.HasHandlerFor( node );
+}
 
-	return false;
+xmlNode* stdXmlReader::WriteResource( stdObject* resource, const char* nodename , stdXmlHandler* handlerToUse )
+{
+	stdXmlParseContext context;
+	return context.WriteResource( resource , nodename , handlerToUse );
 }
 
-stdObject *stdXmlReader::DoCreateResFromNode(xmlNode *node, const std::string& className , stdObject *resource,stdXmlHandler *handlerToUse)
+void stdXmlReader::SetParallelism( unsigned int threads , unsigned int threshold )
 {
-	if( handlerToUse != NULL )
-		return handlerToUse->CreateResource( node , className , resource );
+	boost::mutex::scoped_lock lock( m_mutex );
+	m_threads = threads;
+	m_threshold = threshold;
+}
 
-	stdObject* result = NULL;
-	stdXmlHandler *handler = NULL;
+void stdXmlReader::GetParallelism( unsigned int& threads , unsigned int& threshold )
+{
+	boost::mutex::scoped_lock lock( m_mutex );
+	threads = m_threads;
+	threshold = m_threshold;
+}
 
-	for( unsigned int i = 0; i < m_handlers.size() ; ++i )
-		if( m_handlers[i]->CanHandle( className ) ) {
-			handler = m_handlers[i];
-			break;
-		}
-	
-	if( handler == NULL ) {
-		for( unsigned int i = 0; i < m_handlers.size() ; ++i )
-			if( m_handlers[i]->CanHandle( node ) ) {
-				handler = m_handlers[i];
-				break;
-			}
-	}
-	
-	if( handler != NULL )
-		result = handler->CreateResource( node , className , resource );
+void stdXmlReader::SetParseOptions( int options )
+{
+	boost::mutex::scoped_lock lock( m_mutex );
+	m_options = options;
+}
 
-	return result;
+int stdXmlReader::GetParseOptions()
+{
+	boost::mutex::scoped_lock lock( m_mutex );
+	return m_options;
 }
 
-xmlNode* stdXmlReader::DoWriteResource( stdObject* resource, const char* nodename , stdXmlHandler* handlerToUse )
+void stdXmlReader::SetLazy( bool lazy )
 {
-	if( handlerToUse != NULL )
-		return handlerToUse->WriteResource( resource, nodename );
+	boost::mutex::scoped_lock lock( m_mutex );
+	m_lazy = lazy;
+}
 
-	xmlNode* node = NULL;
+bool stdXmlReader::IsLazy()
+{
+	boost::mutex::scoped_lock lock( m_mutex );
+	return m_lazy;
+}
 
-	for( unsigned int i = 0; i < m_handlers.size() ; ++i )
-		if( m_handlers[i]->CanHandle( resource ) ) {
-			node = m_handlers[i]->WriteResource( resource, nodename );
-			break;
-		}
+void stdXmlReader::SetFragmentCaching( bool caching )
+{
+	boost::mutex::scoped_lock lock( m_mutex );
+	m_caching = caching;
+}
 
-	return node;
+bool stdXmlReader::IsFragmentCaching()
+{
+	boost::mutex::scoped_lock lock( m_mutex );
+	return m_caching;
+}
+
+stdXmlDispatchTablePtr stdXmlReader::GetDispatchTable()
+{
+	boost::mutex::scoped_lock lock( m_mutex );
+
+	if( m_table.get() == NULL ) {
+		std::vector< stdXmlHandlerRegistration > handlers;
+
+		for( unsigned int i = 0; i < m_handlers.size() ; ++i )
+			handlers.push_back( m_registeredHandlers[ m_handlers[i] ] );
+
+		m_table.reset( new stdXmlDispatchTable( handlers ) );
+	}
+
+	return m_table;
 }
 
 std::vector< std::string > stdXmlReader::GetList()
 {
+	boost::mutex::scoped_lock lock( m_mutex );
 	std::vector< std::string > ret;
 
 	stdXmlHandlerRegistrationMap::iterator it = m_registeredHandlers.begin();
@@ -207,6 +302,7 @@ std::vector< std::string > stdXmlReader::GetList()
 
 std::vector< std::string > stdXmlReader::GetDescriptions()
 {
+	boost::mutex::scoped_lock lock( m_mutex );
 	std::vector< std::string > ret;
 
 	stdXmlHandlerRegistrationMap::iterator it = m_registeredHandlers.begin();
@@ -219,8 +315,12 @@ std::vector< std::string > stdXmlReader::GetDescriptions()
 bool stdXmlReader::RegisterXmlHandler( const std::string& name,
 		const std::string& description,
 		stdXmlHandlerConstructor ctor,
-		stdXmlHandlerDestructor dtor )
+		stdXmlHandlerDestructor dtor,
+		const std::string& className,
+		const std::string& nodeName,
+		const char* const* names )
 {
+	boost::mutex::scoped_lock lock( m_mutex );
 	stdXmlHandlerRegistrationMap::iterator it = m_registeredHandlers.find(name);
 
 	if( it != m_registeredHandlers.end() )
@@ -229,31 +329,40 @@ bool stdXmlReader::RegisterXmlHandler( const std::string& name,
 	stdXmlHandlerRegistration info;
 	info.name = name;
 	info.description = description;
+	info.className = className;
+	info.nodeName = nodeName;
 	info.ctor = ctor;
 	info.dtor = dtor;
+	info.names = names;
 
 	m_registeredHandlers[name] = info;
-	
-	stdXmlHandler* handler = CreateXmlHandler( name );
-	m_handlers.push_back( handler );
+	m_handlers.push_back( name );
+	m_table.reset();
 
 	return true;
 }
 
 bool stdXmlReader::UnregisterXmlHandler( const std::string& name )
 {
+	boost::mutex::scoped_lock lock( m_mutex );
 	stdXmlHandlerRegistrationMap::iterator it = m_registeredHandlers.find(name);
 
 	if( it == m_registeredHandlers.end() )
 		return false;
 	
-	RemoveHandlersOfClass( name );
+	std::vector< std::string >::iterator handler = std::find( m_handlers.begin() , m_handlers.end() , name );
+
+	if( handler != m_handlers.end() )
+		m_handlers.erase( handler );
+
 	m_registeredHandlers.erase(it);
+	m_table.reset();
 	return true;
 }
 
 stdXmlHandler* stdXmlReader::CreateXmlHandler( const std::string& name )
 {
+	boost::mutex::scoped_lock lock( m_mutex );
 	stdXmlHandlerRegistrationMap::iterator it = m_registeredHandlers.find(name);
 
 	if( it == m_registeredHandlers.end() )
@@ -265,6 +374,7 @@ stdXmlHandler* stdXmlReader::CreateXmlHandler( const std::string& name )
 
 bool stdXmlReader::Exists( const std::string& name )
 {
+	boost::mutex::scoped_lock lock( m_mutex );
 	stdXmlHandlerRegistrationMap::iterator it = m_registeredHandlers.find(name);
 
 	if( it == m_registeredHandlers.end() )
@@ -275,6 +385,7 @@ bool stdXmlReader::Exists( const std::string& name )
 
 std::string stdXmlReader::GetDescription( const std::string& name )
 {
+	boost::mutex::scoped_lock lock( m_mutex );
 	stdXmlHandlerRegistrationMap::iterator it = m_registeredHandlers.find(name);
 
 	if( it == m_registeredHandlers.end() )
@@ -284,17 +395,26 @@ std::string stdXmlReader::GetDescription( const std::string& name )
 }
 
 
+std::string stdXmlReader::DoGetHandlerClass( const stdXmlHandlerRegistration& info )
+{
+	stdXmlHandler* handler = info.ctor( );
+	std::string className = handler->GetClassInfo()->GetClassName();
+	info.dtor( handler );
+
+	return className;
+}
+
 void stdXmlReader::RemoveHandlersOfClass( const std::string& classInfo )
 {
+	boost::mutex::scoped_lock lock( m_mutex );
 	unsigned int i = 0;
 
 	while( i < m_handlers.size() ) {
-		std::string className = m_handlers[i]->GetClassInfo()->GetClassName();
+		std::string className = DoGetHandlerClass( m_registeredHandlers[ m_handlers[i] ] );
 
 		if( className.compare( classInfo ) == 0 ) {
-			delete m_handlers[i];
-			stdArrayXmlHandler::iterator it = m_handlers.begin() + i;
-			m_handlers.erase(it);
+			m_handlers.erase( m_handlers.begin() + i );
+			m_table.reset();
 		}
 		else {
 			++i;
@@ -305,7 +425,13 @@ void stdXmlReader::RemoveHandlersOfClass( const std::string& classInfo )
 stdXmlHandler::stdXmlHandler():
 	stdObject(),
 	m_node(NULL),
-	m_instance(NULL)
+	m_instance(NULL),
+	m_reader(NULL),
+	m_writer(NULL),
+	m_context(NULL),
+	m_names(NULL),
+	m_interned(false),
+	m_projection(NULL)
 {
 }
 
@@ -314,21 +440,70 @@ stdObject *stdXmlHandler::CreateResource(xmlNode *node, const std::string& class
     xmlNode *myNode = m_node;
     std::string myClass = m_class;
     stdObject *myInstance = m_instance;
+    bool myInterned = m_interned;
+    const stdXmlProjection* myProjection = m_projection;
 
     m_instance = instance;
 
     m_node = node;
     m_class = (char*) node->name;
+    m_interned = m_names != NULL && !m_names->empty() && m_context->IsInterned( node );
+    m_projection = m_context != NULL ? m_context->m_cursor : NULL;
 
     stdObject *returned = DoCreateResource();
 
     m_node = myNode;
     m_class = myClass;
     m_instance = myInstance;
+    m_interned = myInterned;
+    m_projection = myProjection;
 
     return returned;
 }
 
+stdObject *stdXmlHandler::CreateResourceFromStream(xmlTextReaderPtr reader, const std::string& , stdObject *instance)
+{
+	xmlNode *myNode = m_node;
+	std::string myClass = m_class;
+	stdObject *myInstance = m_instance;
+	xmlTextReaderPtr myReader = m_reader;
+	bool myInterned = m_interned;
+	const stdXmlProjection* myProjection = m_projection;
+
+	m_instance = instance;
+	m_reader = reader;
+	m_interned = false;
+	m_projection = m_context != NULL ? m_context->m_cursor : NULL;
+
+	m_node = xmlTextReaderCurrentNode( reader );
+	m_class = (char*) xmlTextReaderConstLocalName( reader );
+
+	stdObject *returned = DoCreateResourceFromStream();
+
+	m_node = myNode;
+	m_class = myClass;
+	m_instance = myInstance;
+	m_reader = myReader;
+	m_interned = myInterned;
+	m_projection = myProjection;
+
+	return returned;
+}
+
+stdObject *stdXmlHandler::DoCreateResourceFromStream()
+{
+	/* handlers which do not know how to read from a stream work on the
+	 * expanded subtree, the reader is left on the element so the caller
+	 * will skip it when moving to the next sibling.
+	 */
+	m_node = xmlTextReaderExpand( m_reader );
+
+	if( m_node == NULL )
+		return NULL;
+
+	return DoCreateResource();
+}
+
 xmlNode* stdXmlHandler::WriteResource( stdObject* resource, const char* nodename )
 {
 	stdObject* myInstance = m_instance;
@@ -346,13 +521,152 @@ xmlNode* stdXmlHandler::WriteResource( stdObject* resource, const char* nodename
 	return node;
 }
 
+void stdXmlHandler::WriteResourceToStream( stdObject* resource, stdXmlWriter* writer, const char* nodename )
+{
+	stdObject* myInstance = m_instance;
+	stdXmlWriter* myWriter = m_writer;
+
+	m_instance = resource;
+	m_writer = writer;
+
+	if( nodename )
+		m_nodename = nodename;
+	else
+		m_nodename = "";
+
+	DoWriteResourceToStream( );
+
+	m_instance = myInstance;
+	m_writer = myWriter;
+}
+
+void stdXmlHandler::DoWriteResourceToStream()
+{
+	/* handlers which do not know how to write to a stream build their node
+	 * and write it as a whole.
+	 */
+	xmlNode* node = DoWriteResource();
+
+	if( node == NULL )
+		return;
+
+	m_writer->WriteNode( node );
+	xmlFreeNode( node );
+}
+
+stdObject *stdXmlHandler::CreateResFromNode(xmlNode *node, const std::string& className, stdObject *instance)
+{
+	if( m_context == NULL )
+		return stdXmlReader::Get()->CreateResFromNode( node , className , instance );
+
+	const stdXmlProjection* cursor = m_context->m_cursor;
+	m_context->m_cursor = DoGetChildProjection( node->name );
+
+	stdObject* result = m_context->CreateResFromNode( node , className , instance );
+
+	m_context->m_cursor = cursor;
+	return result;
+}
+
+stdObject *stdXmlHandler::CreateResFromNode(xmlTextReaderPtr reader, const std::string& className, stdObject *instance)
+{
+	if( m_context == NULL )
+		return stdXmlReader::Get()->CreateResFromStream( reader , className , instance );
+
+	const stdXmlProjection* cursor = m_context->m_cursor;
+	m_context->m_cursor = DoGetChildProjection( xmlTextReaderConstLocalName( reader ) );
+
+	stdObject* result = m_context->CreateResFromStream( reader , className , instance );
+
+	m_context->m_cursor = cursor;
+	return result;
+}
+
+const stdXmlProjection* stdXmlHandler::DoGetChildProjection( const xmlChar* name ) const
+{
+	if( m_projection == NULL || name == NULL )
+		return NULL;
+
+	const stdXmlProjection* child = m_projection->FindChild( (const char*) name );
+
+	return child != NULL && !child->IsComplete() ? child : NULL;
+}
+
+bool stdXmlHandler::DeferResFromNode( xmlNode* node , const char* className , stdXmlLazyMembers& members )
+{
+	/* the elements read partially are loaded right away so that the projection
+	 * applies to their members
+	 */
+	if( m_context == NULL || !m_context->GetLazySource() || m_projection != NULL )
+		return false;
+
+	members.Defer( m_context->GetLazySource() , node , className );
+	return true;
+}
+
+bool stdXmlHandler::DeferResFromRun( xmlNode* node , const char* className , stdXmlLazyMembers& members )
+{
+	if( m_context == NULL || !m_context->GetLazySource() || m_projection != NULL )
+		return false;
+
+	members.DeferRun( m_context->GetLazySource() , node , className );
+	return true;
+}
+
+xmlNode* stdXmlHandler::WriteResToNode( stdObject* resource, const char* nodename )
+{
+	if( m_context == NULL )
+		return stdXmlReader::Get()->WriteResource( resource , nodename );
+
+	return m_context->WriteResource( resource , nodename );
+}
+
+void stdXmlHandler::WriteResToParent( xmlNode* node, stdObject* resource, const char* nodename )
+{
+	xmlNode* childnode = WriteResToNode( resource , nodename );
+
+	if( childnode != NULL )
+		xmlAddChild( node , childnode );
+}
+
+void stdXmlHandler::WriteResToParent( stdXmlWriter* writer, stdObject* resource, const char* nodename )
+{
+	if( m_context != NULL ) {
+		m_context->WriteResourceToStream( resource , writer , nodename );
+		return;
+	}
+
+	stdXmlParseContext context;
+	context.WriteResourceToStream( resource , writer , nodename );
+}
+
+void stdXmlHandler::DoCreateResFromNodes( const std::vector< xmlNode* >& nodes , const std::string& className ,
+		const std::vector< stdObject* >& instances , std::vector< stdObject* >& results )
+{
+	if( m_context != NULL ) {
+		const stdXmlProjection* cursor = m_context->m_cursor;
+		m_context->m_cursor = nodes.empty() ? NULL : DoGetChildProjection( nodes[0]->name );
+
+		m_context->CreateResFromNodes( nodes , className , instances , results );
+
+		m_context->m_cursor = cursor;
+		return;
+	}
+
+	stdXmlParseContext context;
+	context.CreateResFromNodes( nodes , className , instances , results );
+}
+
 void stdXmlHandler::CreateChildren(bool this_hnd_only)
 {
+	stdXmlParseContext localContext;
+	stdXmlParseContext* context = m_context != NULL ? m_context : &localContext;
 	xmlNode* child = m_node->children;
+
 	while( child != NULL ) {
 
-		if( stdXmlReader::Get()->HasHandlerFor( child ) )	
-			stdXmlReader::Get()->DoCreateResFromNode(child, stdEmptyString, NULL, this_hnd_only ? this : NULL);
+		if( context->HasHandlerFor( child ) )	
+			context->CreateResFromNode(child, stdEmptyString, NULL, this_hnd_only ? this : NULL);
 		
 		child = child->next;
 	}
@@ -374,4 +688,3 @@ void stdXmlHandler::CreateChildrenPrivately(xmlNode *rootnode)
 		n = n->next;
     }
 }
-		
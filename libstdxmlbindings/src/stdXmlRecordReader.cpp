@@ -0,0 +1,140 @@
+/**
+ * @file stdXmlRecordReader.cpp
+ * @brief main file for reading the records of an xml file one at a time
+ * @author Nicolas Macherey (nm@graymat.fr)
+ * @version 10.4
+ */
+#include <libxml/xmlreader.h>
+#include <libxml/xpath.h>
+
+#include <string>
+#include <vector>
+#include <map>
+
+#include "stdDefines.h"
+#include "stdException.h"
+
+#include "stdXmlReader.h"
+#include "stdXmlRecordReader.h"
+
+stdXmlRecordReader* stdXmlReader::OpenRecordsFile( const std::string& file )
+{
+	xmlTextReaderPtr reader = xmlReaderForFile( file.c_str() , NULL , GetParseOptions() );
+
+	if( reader == NULL )
+		STD_THROW("Error cannot open document!");
+
+	return new stdXmlRecordReader( reader );
+}
+
+stdXmlRecordReader* stdXmlReader::OpenRecords( const std::string& data )
+{
+	stdXmlRecordReader* records = new stdXmlRecordReader( NULL , data );
+	records->m_reader = xmlReaderForMemory( records->m_data.c_str() , records->m_data.size() , NULL , NULL , GetParseOptions() );
+
+	if( records->m_reader == NULL ) {
+		delete records;
+		STD_THROW("Error cannot open document!");
+	}
+
+	return records;
+}
+
+stdXmlRecordReader::stdXmlRecordReader( xmlTextReaderPtr reader , const std::string& data ):
+	m_reader(reader),
+	m_data(data),
+	m_current(NULL),
+	m_started(false),
+	m_finished(false)
+{
+}
+
+stdXmlRecordReader::~stdXmlRecordReader()
+{
+	if( m_current != NULL )
+		delete m_current;
+
+	if( m_reader != NULL )
+		xmlFreeTextReader( m_reader );
+}
+
+stdObject* stdXmlRecordReader::Release()
+{
+	stdObject* record = m_current;
+	m_current = NULL;
+	return record;
+}
+
+void stdXmlRecordReader::DoReadRoot()
+{
+	m_started = true;
+
+	int ret = xmlTextReaderRead( m_reader );
+
+	while( ret == 1 && xmlTextReaderNodeType( m_reader ) != XML_READER_TYPE_ELEMENT )
+		ret = xmlTextReaderRead( m_reader );
+
+	if( ret != 1 )
+		STD_THROW("Error cannot get your document root !");
+
+	m_rootName = (char*) xmlTextReaderConstLocalName( m_reader );
+
+	if( xmlTextReaderIsEmptyElement( m_reader ) )
+		m_finished = true;
+}
+
+stdObject* stdXmlRecordReader::Next( const std::string& className )
+{
+	if( m_current != NULL ) {
+		delete m_current;
+		m_current = NULL;
+	}
+
+	int ret = 1;
+
+	/* On the first call we enter the root node, then we always move to the next
+	 * sibling of the last record, skipping its subtree if the handler did not
+	 * consume it.
+	 */
+	if( !m_started ) {
+		DoReadRoot();
+
+		if( !m_finished )
+			ret = xmlTextReaderRead( m_reader );
+	}
+	else if( !m_finished )
+		ret = xmlTextReaderNext( m_reader );
+
+	while( !m_finished && ret == 1 ) {
+		int type = xmlTextReaderNodeType( m_reader );
+
+		if( type == XML_READER_TYPE_END_ELEMENT && xmlTextReaderDepth( m_reader ) == 0 ) {
+			m_finished = true;
+			break;
+		}
+
+		if( type == XML_READER_TYPE_ELEMENT ) {
+			m_current = m_context.CreateResFromStream( m_reader , className , NULL , NULL );
+
+			if( m_current != NULL )
+				return m_current;
+		}
+
+		ret = xmlTextReaderNext( m_reader );
+	}
+
+	if( ret < 0 ) {
+		m_finished = true;
+		STD_THROW("Error while reading document!");
+	}
+
+	/* reaching the end of the document before the end of the root means that
+	 * the document is truncated.
+	 */
+	if( ret == 0 && !m_finished ) {
+		m_finished = true;
+		STD_THROW("Error while reading document!");
+	}
+
+	return NULL;
+}
@@ -0,0 +1,443 @@
+/**
+ * @file stdXmlWriter.cpp
+ * @brief main file for writing xml documents without building them in memory
+ * @author Nicolas Macherey (nm@graymat.fr)
+ * @version 10.4
+ */
+#include <libxml/tree.h>
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include <fstream>
+
+#include "stdException.h"
+#include "stdXmlWriter.h"
+
+/** libxml2 indents elements by two spaces and stops indenting after 30 levels */
+#define stdXML_WRITER_INDENT_SIZE 2
+#define stdXML_WRITER_INDENT_MAX 30
+
+static const char stdXmlWriterIndent[] = "                                                            ";
+
+stdXmlWriter::stdXmlWriter( std::string& output , bool format , const char* encoding ):
+	m_out(&output),
+	m_stream(NULL),
+	m_file(NULL),
+	m_format(format),
+	m_open(false),
+	m_rawDepth(0),
+	m_caching(false)
+{
+	DoSetEncoding( encoding );
+}
+
+stdXmlWriter::stdXmlWriter( std::ostream& output , bool format , const char* encoding ):
+	m_out(&m_buffer),
+	m_stream(&output),
+	m_file(NULL),
+	m_format(format),
+	m_open(false),
+	m_rawDepth(0),
+	m_caching(false)
+{
+	DoSetEncoding( encoding );
+	m_buffer.reserve( stdXML_WRITER_BUFFER_SIZE + stdXML_WRITER_BUFFER_SIZE / 4 );
+}
+
+stdXmlWriter::stdXmlWriter( const char* file , bool format , const char* encoding ):
+	m_out(&m_buffer),
+	m_stream(NULL),
+	m_file(NULL),
+	m_format(format),
+	m_open(false),
+	m_rawDepth(0),
+	m_caching(false)
+{
+	DoSetEncoding( encoding );
+
+	std::ofstream* stream = new std::ofstream( file , std::ios::out | std::ios::binary | std::ios::trunc );
+
+	if( !stream->is_open() ) {
+		delete stream;
+		STD_THROW("Error cannot open document!");
+	}
+
+	m_file = stream;
+	m_stream = stream;
+	m_buffer.reserve( stdXML_WRITER_BUFFER_SIZE + stdXML_WRITER_BUFFER_SIZE / 4 );
+}
+
+stdXmlWriter::~stdXmlWriter()
+{
+	m_captures.clear();
+	Flush();
+
+	if( m_file != NULL )
+		delete m_file;
+}
+
+void stdXmlWriter::DoSetEncoding( const char* encoding )
+{
+	m_utf8 = false;
+
+	if( encoding == NULL )
+		return;
+
+	if( !xmlStrEqual( (const xmlChar*) encoding , (const xmlChar*) "UTF-8" ) &&
+			!xmlStrEqual( (const xmlChar*) encoding , (const xmlChar*) "utf-8" ) )
+		STD_THROW("Error unsupported encoding!");
+
+	m_encoding = encoding;
+	m_utf8 = true;
+}
+
+void stdXmlWriter::StartDocument()
+{
+	if( m_utf8 ) {
+		DoWrite( "<?xml version=\"1.0\" encoding=\"" );
+		DoWrite( m_encoding.c_str() , m_encoding.size() );
+		DoWrite( "\"?>\n" );
+	}
+	else
+		DoWrite( "<?xml version=\"1.0\"?>\n" );
+}
+
+void stdXmlWriter::EndDocument()
+{
+	while( !m_names.empty() )
+		EndElement();
+
+	DoWrite( "\n" , 1 );
+	Flush();
+}
+
+void stdXmlWriter::DoStartChild()
+{
+	unsigned int depth = m_names.size();
+
+	if( depth == 0 )
+		return;
+
+	if( m_open ) {
+		DoWrite( ">" , 1 );
+		m_open = false;
+
+		if( DoIsFormatted() )
+			DoWrite( "\n" , 1 );
+	}
+
+	DoIndent( depth );
+}
+
+void stdXmlWriter::DoEndChild()
+{
+	if( !m_names.empty() && DoIsFormatted() )
+		DoWrite( "\n" , 1 );
+}
+
+void stdXmlWriter::StartElement( const char* name , const stdXmlFragment* fragment )
+{
+	DoStartChild();
+
+	if( fragment != NULL && m_caching ) {
+		Capture capture;
+		capture.fragment = fragment;
+		capture.start = m_out->size();
+		capture.depth = m_names.size() + 1;
+		capture.key = DoFragmentKey();
+		m_captures.push_back( capture );
+	}
+
+	DoWrite( "<" , 1 );
+	DoWrite( name );
+
+	m_names.push_back( m_nameBuffer.size() );
+	m_nameBuffer.append( name );
+	m_nameBuffer.push_back( 0 );
+	m_open = true;
+}
+
+void stdXmlWriter::WriteAttribute( const char* name , const char* value )
+{
+	DoWrite( " " , 1 );
+	DoWrite( name );
+	DoWrite( "=\"" , 2 );
+	DoWriteEscaped( value , true );
+	DoWrite( "\"" , 1 );
+}
+
+void stdXmlWriter::WriteString( const char* text )
+{
+	/* like libxml2 elements containing text are not indented, their closing tag
+	 * and their children included.
+	 */
+	if( m_rawDepth == 0 )
+		m_rawDepth = m_names.size();
+
+	if( m_open ) {
+		DoWrite( ">" , 1 );
+		m_open = false;
+	}
+
+	DoWriteEscaped( text , false );
+}
+
+void stdXmlWriter::EndElement()
+{
+	if( m_names.empty() )
+		STD_THROW("Error no element to close!");
+
+	unsigned int depth = m_names.size();
+	size_t offset = m_names.back();
+
+	if( m_open ) {
+		DoWrite( "/>" , 2 );
+		m_open = false;
+	}
+	else {
+		DoIndent( depth - 1 );
+		DoWrite( "</" , 2 );
+		DoWrite( m_nameBuffer.c_str() + offset , m_nameBuffer.size() - offset - 1 );
+		DoWrite( ">" , 1 );
+	}
+
+	m_names.pop_back();
+	m_nameBuffer.resize( offset );
+
+	if( m_rawDepth == depth )
+		m_rawDepth = 0;
+
+	if( !m_captures.empty() && m_captures.back().depth == depth ) {
+		const Capture& capture = m_captures.back();
+		capture.fragment->Set( capture.key , m_out->data() + capture.start , m_out->size() - capture.start );
+		m_captures.pop_back();
+	}
+
+	DoEndChild();
+}
+
+bool stdXmlWriter::WriteFragment( const stdXmlFragment& fragment , const char* name )
+{
+	/* the key does not depend on the start tag of the current element being open */
+	if( !m_caching || !fragment.Matches( DoFragmentKey() , name ) )
+		return false;
+
+	DoStartChild();
+	DoWrite( fragment.Get().data() , fragment.Get().size() );
+	DoEndChild();
+
+	return true;
+}
+
+void stdXmlWriter::WriteElement( const char* name , const char* text )
+{
+	StartElement( name );
+
+	if( *text )
+		WriteString( text );
+
+	EndElement();
+}
+
+/** Get the qualified name of the given node */
+static std::string stdXmlQualifiedName( xmlNs* ns , const xmlChar* name )
+{
+	std::string ret;
+
+	if( ns != NULL && ns->prefix != NULL ) {
+		ret = (const char*) ns->prefix;
+		ret += ':';
+	}
+
+	ret += (const char*) name;
+	return ret;
+}
+
+void stdXmlWriter::WriteNode( xmlNode* node )
+{
+	switch( node->type )
+	{
+	case XML_ELEMENT_NODE :
+		break;
+	case XML_TEXT_NODE :
+		if( node->content != NULL )
+			WriteString( (const char*) node->content );
+		return;
+	case XML_CDATA_SECTION_NODE :
+		WriteString( "" );
+		DoWrite( "<![CDATA[" );
+		if( node->content != NULL )
+			DoWrite( (const char*) node->content );
+		DoWrite( "]]>" );
+		return;
+	case XML_COMMENT_NODE :
+		DoStartChild();
+		DoWrite( "<!--" );
+		if( node->content != NULL )
+			DoWrite( (const char*) node->content );
+		DoWrite( "-->" );
+		DoEndChild();
+		return;
+	default :
+		return;
+	}
+
+	StartElement( stdXmlQualifiedName( node->ns , node->name ).c_str() );
+
+	for( xmlNs* ns = node->nsDef ; ns != NULL ; ns = ns->next ) {
+		std::string name = ns->prefix != NULL ? "xmlns:" + std::string( (const char*) ns->prefix ) : "xmlns";
+		WriteAttribute( name.c_str() , ns->href != NULL ? (const char*) ns->href : "" );
+	}
+
+	for( xmlAttr* attr = node->properties ; attr != NULL ; attr = attr->next ) {
+		xmlChar* value = xmlNodeListGetString( node->doc , attr->children , 0 );
+		WriteAttribute( stdXmlQualifiedName( attr->ns , attr->name ).c_str() , value != NULL ? (const char*) value : "" );
+
+		if( value != NULL )
+			xmlFree( value );
+	}
+
+	/* libxml2 knows that an element contains text before writing its children */
+	for( xmlNode* child = node->children ; child != NULL ; child = child->next ) {
+		if( child->type == XML_TEXT_NODE || child->type == XML_CDATA_SECTION_NODE ||
+				child->type == XML_ENTITY_REF_NODE ) {
+			WriteString( "" );
+			break;
+		}
+	}
+
+	for( xmlNode* child = node->children ; child != NULL ; child = child->next )
+		WriteNode( child );
+
+	EndElement();
+}
+
+void stdXmlWriter::Flush()
+{
+	if( m_stream == NULL || m_buffer.empty() || !m_captures.empty() )
+		return;
+
+	m_stream->write( m_buffer.data() , m_buffer.size() );
+	m_stream->flush();
+	m_buffer.clear();
+}
+
+void stdXmlWriter::DoIndent( unsigned int depth )
+{
+	if( !DoIsFormatted() || depth == 0 )
+		return;
+
+	if( depth > stdXML_WRITER_INDENT_MAX )
+		depth = stdXML_WRITER_INDENT_MAX;
+
+	DoWrite( stdXmlWriterIndent , depth * stdXML_WRITER_INDENT_SIZE );
+}
+
+/** Write the character reference of the given code point in buffer
+  * @return the number of characters written
+  */
+static int stdXmlCharRef( char* buffer , unsigned long code )
+{
+	static const char digits[] = "0123456789ABCDEF";
+	char hex[8];
+	int count = 0;
+
+	do {
+		hex[count++] = digits[code & 0xF];
+		code >>= 4;
+	} while( code != 0 );
+
+	int length = 0;
+	buffer[length++] = '&';
+	buffer[length++] = '#';
+	buffer[length++] = 'x';
+
+	while( count > 0 )
+		buffer[length++] = hex[--count];
+
+	buffer[length++] = ';';
+	return length;
+}
+
+/** Decode the UTF-8 sequence starting at str
+  * @param str sequence to decode, its first byte is not ASCII
+  * @param code [out] decoded code point, or the first byte if the sequence is invalid
+  * @return the length of the sequence
+  */
+static int stdXmlDecodeUTF8( const unsigned char* str , unsigned long& code )
+{
+	int length;
+
+	if( ( str[0] & 0xE0 ) == 0xC0 ) {
+		code = str[0] & 0x1F;
+		length = 2;
+	}
+	else if( ( str[0] & 0xF0 ) == 0xE0 ) {
+		code = str[0] & 0x0F;
+		length = 3;
+	}
+	else if( ( str[0] & 0xF8 ) == 0xF0 ) {
+		code = str[0] & 0x07;
+		length = 4;
+	}
+	else {
+		code = str[0];
+		return 1;
+	}
+
+	for( int i = 1 ; i < length ; ++i ) {
+		if( ( str[i] & 0xC0 ) != 0x80 ) {
+			code = str[0];
+			return 1;
+		}
+
+		code = ( code << 6 ) | ( str[i] & 0x3F );
+	}
+
+	return length;
+}
+
+void stdXmlWriter::DoWriteEscaped( const char* text , bool attribute )
+{
+	const unsigned char* str = (const unsigned char*) text;
+	const unsigned char* run = str;
+
+	for( ; *str != 0 ; ) {
+		const char* replacement = NULL;
+
+		switch( *str )
+		{
+		case '<' : replacement = "&lt;"; break;
+		case '>' : replacement = "&gt;"; break;
+		case '&' : replacement = "&amp;"; break;
+		case '"' : replacement = attribute ? "&quot;" : NULL; break;
+		case '\t' : replacement = attribute ? "&#9;" : NULL; break;
+		case '\n' : replacement = attribute ? "&#10;" : NULL; break;
+		case '\r' : replacement = attribute || m_utf8 ? "&#13;" : "&#xD;"; break;
+		default : break;
+		}
+
+		if( replacement == NULL && ( *str < 0x80 || m_utf8 ) ) {
+			++str;
+			continue;
+		}
+
+		DoWrite( (const char*) run , str - run );
+
+		if( replacement != NULL ) {
+			DoWrite( replacement );
+			++str;
+		}
+		else {
+			unsigned long code;
+			char buffer[16];
+			str += stdXmlDecodeUTF8( str , code );
+			DoWrite( buffer , stdXmlCharRef( buffer , code ) );
+		}
+
+		run = str;
+	}
+
+	DoWrite( (const char*) run , str - run );
+}